@@ -0,0 +1,132 @@
+// Messages per second through channels: a ping-pong between two coroutines
+// and a fan-in of many producers into one consumer, the latter next to the
+// std::queue + SuspendUntil pattern channels replace. Idle coroutines waiting
+// on something else show what the scheduler's polling of predicates costs.
+//
+// usage: channel [round trips] [messages per producer]
+
+#include "conjure/channel.h"
+#include "conjure/interfaces.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <queue>
+#include <vector>
+
+using namespace conjure;
+using Clock = std::chrono::steady_clock;
+
+int round_trips = 20000;
+int per_producer = 2000;
+
+void Pinger(Channel<int> *ping, Channel<int> *pong) {
+    for (int i = 0; i < round_trips; ++i) {
+        ping->Send(i);
+        pong->Recv();
+    }
+    ping->Close();
+}
+
+void Ponger(Channel<int> *ping, Channel<int> *pong) {
+    for (; auto v = ping->Recv();) pong->Send(*v);
+}
+
+void PingPong(size_t capacity) {
+    Channel<int> ping(capacity), pong(capacity);
+    auto start = Clock::now();
+    auto a = Conjure(Config{}, Pinger, &ping, &pong);
+    auto b = Conjure(Config{}, Ponger, &ping, &pong);
+    Resume(a);
+    Resume(b);
+    Wait(a);
+    Wait(b);
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    printf(
+        "ping-pong capacity %zu %29.1f round trips/s\n", capacity,
+        round_trips / elapsed.count());
+}
+
+void Producer(Channel<int> *ch) {
+    for (int i = 0; i < per_producer; ++i) ch->Send(i);
+}
+
+long Consumer(Channel<int> *ch) {
+    long sum = 0;
+    for (; auto v = ch->Recv();) sum += *v;
+    return sum;
+}
+
+std::queue<int> shared_queue;
+int producers_left = 0;
+bool idle_done = false;
+
+void Idle() {
+    SuspendUntil([]() { return idle_done; });
+}
+
+void QueueProducer() {
+    for (int i = 0; i < per_producer; ++i) {
+        SuspendUntil([]() { return shared_queue.size() < 64; });
+        shared_queue.push(i);
+    }
+    --producers_left;
+}
+
+long QueueConsumer() {
+    long sum = 0;
+    for (;;) {
+        SuspendUntil(
+            []() { return not shared_queue.empty() or producers_left == 0; });
+        if (shared_queue.empty()) break;
+        sum += shared_queue.front();
+        shared_queue.pop();
+    }
+    return sum;
+}
+
+void FanIn(int n_producers, bool channel, int n_idle) {
+    idle_done = false;
+    std::vector<Conjury *> idle;
+    for (int i = 0; i < n_idle; ++i) {
+        idle.push_back(Conjure(Config{}, Idle));
+        Resume(idle.back());
+    }
+    Channel<int> ch(64);
+    producers_left = n_producers;
+    auto start = Clock::now();
+    std::vector<Conjury *> producers;
+    for (int i = 0; i < n_producers; ++i) {
+        producers.push_back(
+            channel ? Conjure(Config{}, Producer, &ch)
+                    : Conjure(Config{}, QueueProducer));
+    }
+    auto consumer = channel ? Conjure(Config{}, Consumer, &ch)
+                            : Conjure(Config{}, QueueConsumer);
+    for (auto p : producers) Resume(p);
+    Resume(consumer);
+    for (auto p : producers) Wait(p);
+    ch.Close();
+    long sum = Wait(consumer);
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    idle_done = true;
+    for (auto i : idle) Wait(i);
+    long messages = (long)n_producers * per_producer;
+    printf(
+        "fan-in %3d producers %4d idle %-8s %12.1f messages/s%s\n",
+        n_producers, n_idle, channel ? "channel" : "queue",
+        messages / elapsed.count(),
+        sum == messages * (per_producer - 1) / 2 ? "" : " (wrong sum)");
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1) round_trips = atoi(argv[1]);
+    if (argc > 2) per_producer = atoi(argv[2]);
+    PingPong(0);
+    PingPong(1);
+    for (int idle : {0, 1000}) {
+        for (int n : {1, 8, 64}) {
+            FanIn(n, true, idle);
+            FanIn(n, false, idle);
+        }
+    }
+}
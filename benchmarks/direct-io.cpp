@@ -0,0 +1,85 @@
+// Sequential scan throughput of a local file through the page cache and with
+// O_DIRECT reads into buffers from an aligned pool.
+//
+// usage: direct-io [size in MiB] [file path]
+
+#include "conjure/io/direct-io.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <chrono>
+#include <string>
+
+using namespace conjure;
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t kChunk = 1 << 20;
+
+size_t file_size = 256 << 20;
+std::string path = "./direct-io.dat";
+
+io::AlignedBufferPool pool(kChunk, 4);
+
+bool PrepareFile() {
+    int fd = io::OpenDirect(path.c_str(), O_CREAT | O_TRUNC | O_WRONLY);
+    if (fd == -1) {
+        perror("open O_DIRECT");
+        return false;
+    }
+    auto buffer = pool.Acquire();
+    for (size_t i = 0; i < buffer.Size(); ++i) buffer.Data()[i] = (char)i;
+    for (size_t off = 0; off < file_size; off += kChunk) {
+        if (io::DirectWrite(fd, buffer.Data(), kChunk, off, kChunk / 4) < 0) {
+            perror("direct write");
+            return false;
+        }
+    }
+    io::Close(fd);
+    return true;
+}
+
+void Report(const char *name, size_t bytes, Clock::time_point start) {
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    printf(
+        "%-10s %12zu bytes %10.1f MiB/s\n", name, bytes,
+        bytes / elapsed.count() / (1 << 20));
+}
+
+void Buffered() {
+    int fd = io::Open(path.c_str(), O_RDONLY);
+    auto buffer = pool.Acquire();
+    size_t total = 0;
+    auto start = Clock::now();
+    for (ssize_t n; (n = io::Pread(fd, buffer.Data(), kChunk, total)) > 0;) {
+        total += n;
+    }
+    Report("buffered", total, start);
+    io::Close(fd);
+}
+
+void Direct() {
+    int fd = io::OpenDirect(path.c_str(), O_RDONLY);
+    auto buffer = pool.Acquire();
+    size_t total = 0;
+    auto start = Clock::now();
+    for (ssize_t n; (n = io::DirectRead(
+                         fd, buffer.Data(), kChunk, total, kChunk / 4)) > 0;) {
+        total += n;
+    }
+    Report("direct", total, start);
+    io::Close(fd);
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1) file_size = (size_t)atoi(argv[1]) << 20;
+    if (argc > 2) path = argv[2];
+    if (not PrepareFile()) {
+        puts("O_DIRECT needs a file system that supports it");
+        unlink(path.c_str());
+        return 1;
+    }
+    Buffered();
+    Direct();
+    unlink(path.c_str());
+}
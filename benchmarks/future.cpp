@@ -0,0 +1,56 @@
+// Promise/future round trips per second, set before the await and set by
+// another thread while the awaiting coroutine is suspended.
+//
+// usage: future [round trips]
+
+#include "conjure/future.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace conjure;
+using Clock = std::chrono::steady_clock;
+
+void Report(const char *name, long n, Clock::time_point start) {
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    printf("%-12s %12.1f round trips/s\n", name, n / elapsed.count());
+}
+
+int main(int argc, char **argv) {
+    long n = argc > 1 ? atol(argv[1]) : 200000;
+
+    auto start = Clock::now();
+    long sum = 0;
+    for (long i = 0; i < n; ++i) {
+        Promise<long> p;
+        Future<long> f = p.GetFuture();
+        p.SetValue(i);
+        sum += f.Await();
+    }
+    Report("ready", n, start);
+
+    // a thread fulfilling whatever promise is posted
+    long cross = n / 10;
+    std::atomic<Promise<long> *> slot = nullptr;
+    std::thread setter([&slot, cross] {
+        for (long i = 0; i < cross; ++i) {
+            Promise<long> *p;
+            for (; (p = slot.exchange(nullptr)) == nullptr;) {
+                std::this_thread::yield();
+            }
+            p->SetValue(i);
+        }
+    });
+    start = Clock::now();
+    for (long i = 0; i < cross; ++i) {
+        Promise<long> p;
+        Future<long> f = p.GetFuture();
+        slot.store(&p);
+        sum += f.Await();
+    }
+    Report("thread", cross, start);
+    setter.join();
+    printf("(sum %ld)\n", sum);
+}
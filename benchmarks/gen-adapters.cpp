@@ -0,0 +1,67 @@
+// Elements per second through filter, map and take stages, fused inline
+// in the consumer against one coroutine per stage.
+//
+// usage: gen-adapters [elements]
+
+#include "conjure/gen-adapters.h"
+#include "conjure/interfaces.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+
+using namespace conjure;
+using Clock = std::chrono::steady_clock;
+
+Generating<long> Count(long n) {
+    for (long i = 0; i < n; ++i) YieldWith(i);
+    return {};
+}
+
+Generating<long> Even(ConjuryClient<Generating<long>> *src) {
+    for (long i : src) {
+        if (i % 2 == 0) YieldWith(i);
+    }
+    return {};
+}
+
+Generating<long> Triple(ConjuryClient<Generating<long>> *src) {
+    for (long i : src) YieldWith(i * 3);
+    return {};
+}
+
+Generating<long> Take(ConjuryClient<Generating<long>> *src, long n) {
+    for (long i : src) {
+        if (n-- == 0) break;
+        YieldWith(i);
+    }
+    return {};
+}
+
+void Report(const char *name, long n, long sum, Clock::time_point start) {
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    printf(
+        "%-8s %14.1f elements/s (sum %ld)\n", name, n / elapsed.count(), sum);
+}
+
+int main(int argc, char **argv) {
+    long n = argc > 1 ? atol(argv[1]) : 2000000;
+
+    auto start = Clock::now();
+    long sum = 0;
+    auto even = Conjure(Config{}, Even, Conjure(Config{}, Count, n));
+    for (long i :
+         Conjure(Config{}, Take, Conjure(Config{}, Triple, even), n / 4)) {
+        sum += i;
+    }
+    Report("stages", n, sum, start);
+
+    start = Clock::now();
+    sum = 0;
+    for (long i : Conjure(Config{}, Count, n) |
+                      gen::Filter([](long i) { return i % 2 == 0; }) |
+                      gen::Map([](long i) { return i * 3; }) |
+                      gen::Take(n / 4)) {
+        sum += i;
+    }
+    Report("fused", n, sum, start);
+}
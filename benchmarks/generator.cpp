@@ -0,0 +1,51 @@
+// Elements per second through a generator yielding one value per switch,
+// next to chunked generators emitting into buffers of different sizes.
+//
+// usage: generator [elements]
+
+#include "conjure/chunked.h"
+#include "conjure/gen-iterator.h"
+#include "conjure/interfaces.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+
+using namespace conjure;
+using Clock = std::chrono::steady_clock;
+
+Generating<long> Count(long n) {
+    for (long i = 0; i < n; ++i) YieldWith(i);
+    return {};
+}
+
+Generating<Chunk<long>> CountChunked(long n, int chunk) {
+    Emitter<long> out(chunk);
+    for (long i = 0; i < n; ++i) out.Emit(i);
+    return {};
+}
+
+void Report(
+    const char *name, int chunk, long n, long sum, Clock::time_point start) {
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    printf(
+        "%-8s chunk %5d %14.1f elements/s%s\n", name, chunk,
+        n / elapsed.count(), sum == n * (n - 1) / 2 ? "" : " (wrong sum)");
+}
+
+int main(int argc, char **argv) {
+    long n = argc > 1 ? atol(argv[1]) : 2000000;
+
+    auto start = Clock::now();
+    long sum = 0;
+    for (long i : Conjure(Config{}, Count, n)) sum += i;
+    Report("single", 1, n, sum, start);
+
+    for (int chunk : {1, 16, 256, 4096}) {
+        start = Clock::now();
+        sum = 0;
+        for (long i : Elements(Conjure(Config{}, CountChunked, n, chunk))) {
+            sum += i;
+        }
+        Report("chunked", chunk, n, sum, start);
+    }
+}
@@ -0,0 +1,61 @@
+// Commits per second of a write-ahead log with an increasing number of
+// concurrent writers, each appending a record and committing it, with and
+// without group commit.
+//
+// usage: group-commit [commits per writer] [log path]
+
+#include "conjure/interfaces.h"
+#include "conjure/io/group-commit.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+using namespace conjure;
+using Clock = std::chrono::steady_clock;
+
+int commits_per_writer = 50;
+std::string log_path = "./group-commit.log";
+
+void Writer(int fd, io::GroupCommit *group) {
+    const char record[] = "0123456789abcdef0123456789abcdef";
+    for (int i = 0; i < commits_per_writer; ++i) {
+        io::Write(fd, record, sizeof(record) - 1);
+        if (group != nullptr) {
+            group->Commit(fd);
+        } else {
+            io::Fdatasync(fd);
+        }
+    }
+}
+
+void Measure(int n_writers, bool grouped) {
+    int fd = io::Open(log_path.c_str(), O_CREAT | O_TRUNC | O_WRONLY);
+    io::GroupCommit group;
+    std::vector<Conjury *> writers;
+    auto start = Clock::now();
+    for (int i = 0; i < n_writers; ++i) {
+        writers.push_back(
+            Conjure(Config{}, Writer, fd, grouped ? &group : nullptr));
+    }
+    for (auto w : writers) Resume(w);
+    for (auto w : writers) Wait(w);
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    io::Close(fd);
+    int commits = n_writers * commits_per_writer;
+    printf(
+        "%3d writers %-8s %10.1f commits/s %6d syncs\n", n_writers,
+        grouped ? "grouped" : "direct", commits / elapsed.count(),
+        grouped ? group.Syncs() : commits);
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1) commits_per_writer = atoi(argv[1]);
+    if (argc > 2) log_path = argv[2];
+    for (int n : {1, 4, 16, 64}) {
+        Measure(n, false);
+        Measure(n, true);
+    }
+    unlink(log_path.c_str());
+}
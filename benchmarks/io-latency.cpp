@@ -0,0 +1,53 @@
+// Measures the time between submitting an io job and being resumed with its
+// result while a growing number of other coroutines sit in the suspended
+// queue. The latency should not grow with the number of idle coroutines.
+
+#include "conjure/interfaces.h"
+#include "conjure/io/interfaces.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <vector>
+
+using namespace conjure;
+using Clock = std::chrono::steady_clock;
+
+int rounds = 2000;
+
+bool idle_finished = false;
+
+void Idle() {
+    SuspendUntil([]() { return idle_finished; });
+}
+
+double MeasureRead(int fd) {
+    char buffer[64];
+    auto start = Clock::now();
+    for (int i = 0; i < rounds; ++i) {
+        io::Read(fd, buffer, sizeof(buffer));
+    }
+    std::chrono::duration<double, std::micro> elapsed = Clock::now() - start;
+    return elapsed.count() / rounds;
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1) {
+        rounds = atoi(argv[1]);
+    }
+    int fd = io::Open("/dev/zero", O_RDONLY);
+    if (fd == -1) {
+        puts("error open /dev/zero");
+        return 1;
+    }
+    std::vector<Conjury *> idles;
+    for (int n_idle : {0, 100, 1000, 10000}) {
+        for (; (int)idles.size() < n_idle;) {
+            idles.push_back(Conjure(Config{}, Idle));
+            Resume(idles.back());
+        }
+        printf("%6d suspended: %8.2f us per read\n", n_idle, MeasureRead(fd));
+    }
+    idle_finished = true;
+    for (auto c : idles) Wait(c);
+}
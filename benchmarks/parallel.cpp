@@ -0,0 +1,56 @@
+// Items per second through ParallelForEach with handlers that wait on a
+// timer, by concurrency, and through ParallelReduce with CPU-bound work,
+// by thread count.
+//
+// usage: parallel [items] [max threads]
+
+#include "conjure/parallel.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <functional>
+#include <numeric>
+#include <vector>
+
+using namespace conjure;
+using Clock = std::chrono::steady_clock;
+
+long Spin(long x) {
+    for (int i = 0; i < 1000; ++i) {
+        x = x * 6364136223846793005L + 1442695040888963407L;
+        asm volatile("" : "+r"(x));
+    }
+    return x & 1;
+}
+
+void Report(const char *name, int n, long items, Clock::time_point start) {
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    printf("%-8s %4d %14.1f items/s\n", name, n, items / elapsed.count());
+}
+
+int main(int argc, char **argv) {
+    long n = argc > 1 ? atol(argv[1]) : 100000;
+    int max_threads = argc > 2 ? atoi(argv[2]) : 4;
+    std::vector<long> items(n);
+    std::iota(items.begin(), items.end(), 0);
+
+    long waits = n / 100;
+    for (int concurrency : {1, 16, 256}) {
+        auto start = Clock::now();
+        ParallelForEach(
+            std::vector<long>(items.begin(), items.begin() + waits),
+            [](long) { SleepFor(std::chrono::microseconds(500)); },
+            concurrency);
+        Report("timer", concurrency, waits, start);
+    }
+
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        ParallelConfig config;
+        config.concurrency = 8 * threads;
+        config.threads = threads;
+        auto start = Clock::now();
+        long odd = ParallelReduce(items, 0L, Spin, std::plus<long>(), config);
+        Report("spin", threads, n, start);
+        if (odd < 0) printf("?\n");
+    }
+}
@@ -0,0 +1,54 @@
+// A producer and a consumer each spending `work` iterations per value, run
+// as a plain generator and prefetched on a thread of its own. With two free
+// cores the prefetched run should take about half the time.
+//
+// usage: prefetch [values] [work] [depth]
+
+#include "conjure/prefetch.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+
+using namespace conjure;
+using Clock = std::chrono::steady_clock;
+
+long Spin(long x, int work) {
+    for (int i = 0; i < work; ++i) {
+        x = x * 6364136223846793005L + 1442695040888963407L;
+        asm volatile("" : "+r"(x));
+    }
+    return x;
+}
+
+Generating<long> Produce(long n, int work) {
+    for (long i = 0; i < n; ++i) {
+        Spin(i, work);
+        YieldWith(i);
+    }
+    return {};
+}
+
+template <typename Co>
+void Consume(const char *name, Co *co, long n, int work) {
+    auto start = Clock::now();
+    long sum = 0;
+    for (long i : co) {
+        Spin(i, work);
+        sum += i;
+    }
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    printf(
+        "%-10s %12.1f values/s%s\n", name, n / elapsed.count(),
+        sum == n * (n - 1) / 2 ? "" : " (wrong sum)");
+}
+
+int main(int argc, char **argv) {
+    long n = argc > 1 ? atol(argv[1]) : 200000;
+    int work = argc > 2 ? atoi(argv[2]) : 200;
+    PrefetchConfig prefetch;
+    prefetch.depth = argc > 3 ? atoi(argv[3]) : 256;
+
+    Consume("inline", Conjure(Config{}, Produce, n, work), n, work);
+    Consume(
+        "prefetched", Prefetch(Config{}, prefetch, Produce, n, work), n, work);
+}
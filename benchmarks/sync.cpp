@@ -0,0 +1,121 @@
+// Operations per second of the coroutine synchronization primitives with an
+// increasing number of contending coroutines, each holding the primitive
+// across a Yield(). The mutex is also measured against a flag polled with
+// SuspendUntil, the pattern it replaces; idle coroutines waiting on something
+// else show what polling costs the latter.
+//
+// usage: sync [rounds per coroutine] [idle coroutines]
+
+#include "conjure/interfaces.h"
+#include "conjure/sync.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+using namespace conjure;
+using Clock = std::chrono::steady_clock;
+
+int rounds = 2000;
+bool idle_done = false;
+
+void Idle() {
+    SuspendUntil([]() { return idle_done; });
+}
+
+template <typename F>
+void Measure(const char *name, int n, F body) {
+    std::vector<Conjury *> cos;
+    auto start = Clock::now();
+    for (int i = 0; i < n; ++i) {
+        cos.push_back(Conjure(Config{}, [&body, i]() {
+            for (int r = 0; r < rounds; ++r) body(i);
+        }));
+    }
+    for (auto c : cos) Resume(c);
+    for (auto c : cos) Wait(c);
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    printf(
+        "%-16s %3d coroutines %12.1f ops/s\n", name, n,
+        (double)n * rounds / elapsed.count());
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1) rounds = atoi(argv[1]);
+    int n_idle = argc > 2 ? atoi(argv[2]) : 0;
+    std::vector<Conjury *> idle;
+    for (int i = 0; i < n_idle; ++i) {
+        idle.push_back(Conjure(Config{}, Idle));
+        Resume(idle.back());
+    }
+
+    for (int n : {1, 8, 64}) {
+        Mutex mutex;
+        Measure("mutex", n, [&](int) {
+            mutex.lock();
+            Yield();
+            mutex.unlock();
+        });
+
+        bool locked = false;
+        Measure("polled flag", n, [&](int) {
+            SuspendUntil([&locked]() { return not locked; });
+            locked = true;
+            Yield();
+            locked = false;
+        });
+
+        SharedMutex shared;
+        // one writer for every eight readers
+        Measure("shared mutex", n, [&](int i) {
+            if (i % 8 == 0) {
+                shared.lock();
+                Yield();
+                shared.unlock();
+            } else {
+                shared.lock_shared();
+                Yield();
+                shared.unlock_shared();
+            }
+        });
+
+        Semaphore semaphore(4);
+        Measure("semaphore(4)", n, [&](int) {
+            semaphore.Acquire();
+            Yield();
+            semaphore.Release();
+        });
+
+        Barrier barrier(n);
+        Measure("barrier", n, [&](int) { barrier.ArriveAndWait(); });
+
+        Mutex cv_mutex;
+        ConditionVariable cv;
+        int turn = 0;
+        // coroutines take turns in order
+        Measure("condition var", n, [&](int i) {
+            std::unique_lock<Mutex> hold(cv_mutex);
+            cv.Wait(hold, [&]() { return turn % n == i; });
+            ++turn;
+            cv.NotifyAll();
+        });
+    }
+
+    // uncontended fast path
+    Mutex mutex;
+    auto start = Clock::now();
+    for (int i = 0; i < rounds * 1000; ++i) {
+        mutex.lock();
+        asm volatile("" ::: "memory");
+        mutex.unlock();
+        asm volatile("" ::: "memory");
+    }
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    printf(
+        "%-16s %3d coroutines %12.1f ops/s\n", "mutex uncontended", 1,
+        rounds * 1000 / elapsed.count());
+
+    idle_done = true;
+    for (auto i : idle) Wait(i);
+}
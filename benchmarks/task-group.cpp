@@ -0,0 +1,51 @@
+// Children per second for a fan-out of trivial children, conjured and
+// waited for one by one against spawned into a TaskGroup.
+//
+// usage: task-group [children] [rounds]
+
+#include "conjure/task-group.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <vector>
+
+using namespace conjure;
+using Clock = std::chrono::steady_clock;
+
+long Square(long i) {
+    return i * i;
+}
+
+void Report(const char *name, long n, long sum, Clock::time_point start) {
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    printf("%-8s %12.1f children/s (sum %ld)\n", name, n / elapsed.count(),
+           sum);
+}
+
+int main(int argc, char **argv) {
+    int children = argc > 1 ? atoi(argv[1]) : 1000;
+    int rounds = argc > 2 ? atoi(argv[2]) : 100;
+    long total = (long)children * rounds;
+
+    auto start = Clock::now();
+    long sum = 0;
+    std::vector<ConjuryClient<long> *> cos(children);
+    for (int r = 0; r < rounds; ++r) {
+        for (int i = 0; i < children; ++i) {
+            cos[i] = Conjure(Config{}, Square, (long)i);
+        }
+        for (auto co : cos) sum += Wait(co);
+    }
+    Report("wait", total, sum, start);
+
+    start = Clock::now();
+    sum = 0;
+    for (int r = 0; r < rounds; ++r) {
+        TaskGroup<long> group;
+        for (int i = 0; i < children; ++i) {
+            group.Spawn(Config{}, Square, (long)i);
+        }
+        for (long s : group.WaitAll()) sum += s;
+    }
+    Report("group", total, sum, start);
+}
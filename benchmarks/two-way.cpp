@@ -0,0 +1,60 @@
+// Values per second sent into a generator and answered, as a two-way
+// generator and with a side-channel queue polled by a plain generator.
+//
+// usage: two-way [values]
+
+#include "conjure/gen-iterator.h"
+#include "conjure/interfaces.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <queue>
+
+using namespace conjure;
+using Clock = std::chrono::steady_clock;
+
+Generating<long, long> Square() {
+    long in = Received<long>();
+    for (;;) in = YieldWith<long>(in * in);
+    return {};
+}
+
+std::queue<long> inbox;
+
+Generating<long> SquareQueued() {
+    for (;;) {
+        SuspendUntil([] { return not inbox.empty(); });
+        long in = inbox.front();
+        inbox.pop();
+        YieldWith(in * in);
+    }
+    return {};
+}
+
+void Report(const char *name, long n, long sum, Clock::time_point start) {
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    printf("%-8s %14.1f values/s (sum %ld)\n", name, n / elapsed.count(), sum);
+}
+
+int main(int argc, char **argv) {
+    long n = argc > 1 ? atol(argv[1]) : 1000000;
+
+    auto start = Clock::now();
+    long sum = 0;
+    auto square = Conjure(Config{}, Square);
+    for (long i = 0; i < n; ++i) {
+        GenMoveNext(square, i);
+        sum += *square->GetGenPtr();
+    }
+    Report("two-way", n, sum, start);
+
+    start = Clock::now();
+    sum = 0;
+    auto queued = Conjure(Config{}, SquareQueued);
+    for (long i = 0; i < n; ++i) {
+        inbox.push(i);
+        GenMoveNext(queued);
+        sum += *queued->GetGenPtr();
+    }
+    Report("queued", n, sum, start);
+}
@@ -0,0 +1,56 @@
+// Elements per second through a chain of nested generators, each level
+// either re-yielding every value of the one below or delegating to it with
+// YieldFrom.
+//
+// usage: yield-from [elements]
+
+#include "conjure/gen-iterator.h"
+#include "conjure/interfaces.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+
+using namespace conjure;
+using Clock = std::chrono::steady_clock;
+
+Generating<long> Source(long n) {
+    for (long i = 0; i < n; ++i) YieldWith(i);
+    return {};
+}
+
+Generating<long> Relay(long n, int depth) {
+    if (depth == 0) {
+        for (long i : Conjure(Config{}, Source, n)) YieldWith(i);
+    } else {
+        for (long i : Conjure(Config{}, Relay, n, depth - 1)) YieldWith(i);
+    }
+    return {};
+}
+
+Generating<long> Delegate(long n, int depth) {
+    if (depth == 0) {
+        YieldFrom(Conjure(Config{}, Source, n));
+    } else {
+        YieldFrom(Conjure(Config{}, Delegate, n, depth - 1));
+    }
+    return {};
+}
+
+template <typename F>
+void Measure(const char *name, F gen, long n, int depth) {
+    auto start = Clock::now();
+    long sum = 0;
+    for (long i : Conjure(Config{}, gen, n, depth)) sum += i;
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    printf(
+        "%-10s depth %3d %14.1f elements/s%s\n", name, depth,
+        n / elapsed.count(), sum == n * (n - 1) / 2 ? "" : " (wrong sum)");
+}
+
+int main(int argc, char **argv) {
+    long n = argc > 1 ? atol(argv[1]) : 200000;
+    for (int depth : {1, 4, 16, 64}) {
+        Measure("re-yield", Relay, n, depth);
+        Measure("yield-from", Delegate, n, depth);
+    }
+}
@@ -0,0 +1,97 @@
+// Copies a large local file through a user space read/write loop and through
+// the zero-copy jobs, printing the throughput of each.
+//
+// usage: zero-copy [size in MiB] [file path]
+
+#include "conjure/io/interfaces.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <chrono>
+#include <memory>
+#include <string>
+
+using namespace conjure;
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t kChunk = 128 * 1024;
+constexpr size_t kPipeChunk = 64 * 1024; // default pipe capacity
+
+size_t file_size = 256 << 20;
+std::string src_path = "./zero-copy.src";
+std::string dst_path = "./zero-copy.dst";
+
+bool PrepareSource() {
+    int fd = io::Open(src_path.c_str(), O_CREAT | O_TRUNC | O_WRONLY);
+    if (fd == -1) return false;
+    std::unique_ptr<char[]> chunk(new char[kChunk]);
+    for (size_t i = 0; i < kChunk; ++i) chunk[i] = (char)i;
+    for (size_t off = 0; off < file_size; off += kChunk) {
+        io::Pwrite(fd, chunk.get(), kChunk, off);
+    }
+    close(fd);
+    return true;
+}
+
+ssize_t ReadWriteLoop(int in, int out) {
+    std::unique_ptr<char[]> buffer(new char[kChunk]);
+    ssize_t total = 0;
+    for (int n; (n = io::Read(in, buffer.get(), kChunk)) > 0; total += n) {
+        io::Write(out, buffer.get(), n);
+    }
+    return total;
+}
+
+ssize_t SendfileCopy(int in, int out) {
+    return io::Sendfile(out, in, nullptr, file_size);
+}
+
+ssize_t CopyFileRangeCopy(int in, int out) {
+    return io::CopyFileRange(in, nullptr, out, nullptr, file_size);
+}
+
+ssize_t SpliceCopy(int in, int out) {
+    int pipe_fds[2];
+    if (pipe(pipe_fds) == -1) return -1;
+    ssize_t total = 0;
+    for (ssize_t n; (n = io::Splice(in, nullptr, pipe_fds[1], nullptr,
+                                    kPipeChunk, SPLICE_F_MOVE)) > 0;
+         total += n) {
+        io::Splice(pipe_fds[0], nullptr, out, nullptr, n, SPLICE_F_MOVE);
+    }
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+    return total;
+}
+
+void Measure(const char *name, ssize_t (*copy)(int, int)) {
+    int in = io::Open(src_path.c_str(), O_RDONLY);
+    int out = io::Open(dst_path.c_str(), O_CREAT | O_TRUNC | O_WRONLY);
+    auto start = Clock::now();
+    ssize_t n = copy(in, out);
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    close(in);
+    close(out);
+    printf(
+        "%-16s %10zd bytes %10.1f MiB/s\n", name, n,
+        n / elapsed.count() / (1 << 20));
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1) file_size = (size_t)atoi(argv[1]) << 20;
+    if (argc > 2) {
+        src_path = argv[2];
+        dst_path = src_path + ".dst";
+    }
+    if (not PrepareSource()) {
+        puts("error preparing source file");
+        return 1;
+    }
+    Measure("read/write", ReadWriteLoop);
+    Measure("sendfile", SendfileCopy);
+    Measure("splice", SpliceCopy);
+    Measure("copy_file_range", CopyFileRangeCopy);
+    unlink(src_path.c_str());
+    unlink(dst_path.c_str());
+}
@@ -0,0 +1,30 @@
+#include "conjure/io/interfaces.h"
+#include <stdio.h>
+
+using namespace conjure;
+
+int main() {
+    int fd = io::Open("/dev/zero", O_RDONLY);
+    int null_fd = io::Open("/dev/null", O_WRONLY);
+    if (fd == -1 or null_fd == -1) {
+        puts("error open file");
+        return 1;
+    }
+
+    // heterogeneous jobs, one submission and one suspension
+    char a[16], b[32];
+    io::job::Read read_a(fd, a, sizeof(a));
+    io::job::Read read_b(fd, b, sizeof(b));
+    io::job::Write write(null_fd, "conjure", 7);
+    auto [na, nb, nw] = io::WhenAll(read_a, read_b, write);
+    printf("read %d, read %d, wrote %d\n", na, nb, nw); // 16, 32, 7
+
+    // resume as soon as any job is done, the rest are awaited by the batch
+    char chunks[4][64];
+    io::job::Read r0(fd, chunks[0], 64), r1(fd, chunks[1], 64),
+        r2(fd, chunks[2], 64), r3(fd, chunks[3], 64);
+    io::Batch batch(r0, r1, r2, r3);
+    int first = batch.WaitAny();
+    printf("job %d finished first\n", first);
+    printf("%d jobs finished\n", batch.WaitAll()); // 4
+}
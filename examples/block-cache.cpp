@@ -0,0 +1,41 @@
+#include "conjure/interfaces.h"
+#include "conjure/io/block-cache.h"
+#include <stdio.h>
+#include <vector>
+
+using namespace conjure;
+
+io::BlockCache cache(io::BlockCache::Options{4096, 1 << 20, 4});
+
+void Lookup(int fd, int id) {
+    char header[8] = {};
+    cache.Read(fd, header, 7, 0);
+    printf("reader %d: %s\n", id, header);
+}
+
+int main() {
+    int fd = io::Open("./index.bin", O_CREAT | O_TRUNC | O_RDWR);
+    if (fd == -1) {
+        puts("error open file");
+        return 1;
+    }
+    io::Write(fd, "conjure index");
+
+    // four concurrent misses on one block become a single read
+    std::vector<Conjury *> readers;
+    for (int i = 0; i < 4; ++i) {
+        readers.push_back(Conjure(Config{}, Lookup, fd, i));
+    }
+    for (auto r : readers) Resume(r);
+    for (auto r : readers) Wait(r);
+
+    // served from memory
+    Lookup(fd, 4);
+
+    auto stats = cache.GetStats();
+    printf(
+        "hits: %lu, misses: %lu, coalesced: %lu\n", stats.hits, stats.misses,
+        stats.coalesced); // 1, 1, 3
+    cache.Invalidate(fd);
+    close(fd);
+}
@@ -0,0 +1,33 @@
+#include "conjure/io/buffered-stream.h"
+#include <stdio.h>
+#include <string>
+
+using namespace conjure;
+
+int main() {
+    int fd = io::Open("./lines.txt", O_CREAT | O_TRUNC | O_WRONLY);
+    if (fd == -1) {
+        puts("error open file");
+        return 1;
+    }
+    {
+        // a thousand small writes, a handful of worker round trips
+        io::BufferedWriter writer(fd, 4096);
+        for (int i = 0; i < 1000; ++i) {
+            writer.Write("line " + std::to_string(i) + "\n");
+        }
+    } // flushed here
+    close(fd);
+
+    fd = io::Open("./lines.txt", O_RDONLY);
+    io::BufferedReader reader(fd, 4096, true);
+    printf("peek: %.4s\n", reader.Peek(4).data()); // line
+
+    std::string line;
+    int count = 0;
+    for (; reader.ReadLine(line); ++count) {
+        if (count % 250 == 0) printf("%s\n", line.c_str());
+    }
+    printf("%d lines\n", count); // 1000
+    close(fd);
+}
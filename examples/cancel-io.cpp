@@ -0,0 +1,46 @@
+#include "conjure/interfaces.h"
+#include "conjure/io/interfaces.h"
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+using namespace conjure;
+
+io::CancelToken token;
+
+// blocks on a pipe nobody writes to
+void Reader(int fd) {
+    char buffer[64];
+    int n = io::Read(fd, buffer, sizeof(buffer), token);
+    printf("reader: %d, %s\n", n, strerror(errno)); // -1, Operation canceled
+}
+
+// gives up on the reader, e.g. a deadline or a client disconnect
+void Watchdog() {
+    int fd = io::Open("/dev/zero", O_RDONLY);
+    char buffer[64];
+    for (int i = 0; i < 3; ++i) io::Read(fd, buffer, sizeof(buffer));
+    puts("watchdog: cancel");
+    token.Cancel();
+    close(fd);
+}
+
+int main() {
+    int pipe_fds[2];
+    if (pipe(pipe_fds) == -1) {
+        puts("error creating pipe");
+        return 1;
+    }
+    auto reader = Conjure(Config{"reader"}, Reader, pipe_fds[0]);
+    auto watchdog = Conjure(Config{"watchdog"}, Watchdog);
+    Resume(reader);
+    Resume(watchdog);
+    Wait(reader);
+    Wait(watchdog);
+
+    // a cancelled token fails the next call right away
+    char buffer[8];
+    int n = io::Read(pipe_fds[0], buffer, sizeof(buffer), token);
+    printf("main: %d, %s\n", n, strerror(errno));
+}
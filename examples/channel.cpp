@@ -0,0 +1,54 @@
+#include "conjure/channel.h"
+#include "conjure/interfaces.h"
+#include <stdio.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+using namespace conjure;
+
+constexpr int kNProducer = 2;
+constexpr int kNConsumer = 3;
+
+void Producer(int id, Channel<std::string> *ch) {
+    for (int i = 1; i <= 3; ++i) {
+        ch->Send("product " + std::to_string(id * 10 + i));
+    }
+}
+
+void Consumer(int id, Channel<std::string> *ch) {
+    for (; auto product = ch->Recv();) {
+        printf("consumer %d: %s\n", id, product->c_str());
+    }
+    printf("consumer %d: closed\n", id);
+}
+
+int main() {
+    // producers park after two unconsumed products
+    Channel<std::string> ch(2);
+    std::vector<Conjury *> producers, consumers;
+    for (int i = 0; i < kNProducer; ++i)
+        producers.push_back(Conjure(Config{}, Producer, i, &ch));
+    for (int i = 0; i < kNConsumer; ++i)
+        consumers.push_back(Conjure(Config{}, Consumer, i, &ch));
+
+    for (auto p : producers) Resume(p);
+    for (auto c : consumers) Resume(c);
+    for (auto p : producers) Wait(p);
+    ch.Close();
+    for (auto c : consumers) Wait(c);
+
+    std::string s = "kept";
+    printf("try send: %d, %s\n", ch.TrySend(s), s.c_str());
+
+    // a stray wake-up doesn't pull a receiver out before it got a value
+    Channel<int> numbers;
+    auto receiver = Conjure(Config{}, [&numbers] {
+        printf("received: %d\n", *numbers.Recv()); // 42
+    });
+    Resume(receiver);
+    receiver->Wake();
+    SleepFor(std::chrono::milliseconds(1));
+    numbers.Send(42);
+    Wait(receiver);
+}
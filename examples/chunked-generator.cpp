@@ -0,0 +1,43 @@
+#include "conjure/chunked.h"
+#include "conjure/interfaces.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <string>
+#include <string_view>
+
+using namespace conjure;
+
+// hands words over eight at a time
+Generating<Chunk<std::string_view>> Words(std::string_view text) {
+    Emitter<std::string_view> out(8);
+    for (size_t i = 0; i < text.size();) {
+        for (; i < text.size() and isspace(text[i]); ++i) continue;
+        size_t start = i;
+        for (; i < text.size() and not isspace(text[i]); ++i) continue;
+        if (i > start) out.Emit(text.substr(start, i - start));
+    }
+    return {};
+}
+
+// already in memory, handed over in one go
+Generating<Chunk<int>> Table() {
+    static const int kTable[] = {2, 3, 5, 7, 11, 13};
+    YieldMany(kTable);
+    return {};
+}
+
+int main() {
+    int n = 0;
+    for (std::string_view w : Elements(Conjure(
+             Config{}, Words,
+             "the quick brown fox jumps over the lazy dog again and again"))) {
+        printf("%d: %.*s\n", n++, (int)w.size(), w.data());
+    }
+
+    // the chunks themselves are visible too
+    for (const Chunk<int> &chunk : Conjure(Config{}, Table)) {
+        printf("chunk of %zu:", chunk.size);
+        for (int v : chunk) printf(" %d", v);
+        putchar('\n');
+    }
+}
@@ -0,0 +1,85 @@
+// Results from callback-style and thread-based code handed to coroutines.
+
+#include "conjure/future.h"
+#include <stdio.h>
+#include <chrono>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace conjure;
+
+// a fake RPC stub answering on a thread of its own
+class Client {
+  public:
+    ~Client() {
+        for (auto &t : threads_) t.join();
+    }
+
+    void Call(int key, std::function<void(std::string)> done) {
+        threads_.emplace_back([key, done = std::move(done)] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10 * key));
+            done("value-" + std::to_string(key));
+        });
+    }
+
+  private:
+    std::vector<std::thread> threads_;
+};
+
+Future<std::string> Lookup(Client &client, int key) {
+    auto promise = std::make_shared<Promise<std::string>>();
+    Future<std::string> future = promise->GetFuture();
+    client.Call(key, [promise](std::string v) {
+        promise->SetValue(std::move(v));
+    });
+    return future;
+}
+
+void Fetch(Client *client, int key) {
+    std::string v = Lookup(*client, key).Await();
+    printf("coroutine %d got %s\n", key, v.c_str());
+}
+
+int main() {
+    Client client;
+    std::vector<Conjury *> fetchers;
+    for (int key : {3, 1, 2}) {
+        fetchers.push_back(Conjure(Config{}, Fetch, &client, key));
+    }
+    for (Conjury *co : fetchers) Resume(co);
+    for (Conjury *co : fetchers) Wait(co);
+
+    // failures travel as exceptions
+    Promise<int> failing;
+    Future<int> failed = failing.GetFuture();
+    std::thread([p = std::move(failing)]() mutable {
+        p.SetException(std::make_exception_ptr(std::runtime_error("no")));
+    }).join();
+    try {
+        failed.Await();
+    } catch (const std::exception &e) {
+        printf("failed: %s\n", e.what());
+    }
+
+    // a promise assigned over is broken, its future doesn't hang
+    Promise<int> replaced;
+    Future<int> orphan = replaced.GetFuture();
+    replaced = Promise<int>();
+    try {
+        orphan.Await();
+    } catch (const BrokenPromise &e) {
+        printf("replaced: %s\n", e.what());
+    }
+
+    // and plain threads block on a future instead
+    Promise<void> go;
+    std::thread waiter([f = go.GetFuture()]() mutable {
+        f.Get();
+        printf("thread released\n");
+    });
+    go.SetValue();
+    waiter.join();
+}
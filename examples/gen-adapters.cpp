@@ -0,0 +1,61 @@
+#include "conjure/gen-adapters.h"
+#include "conjure/interfaces.h"
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+using namespace conjure;
+
+Generating<int> Naturals(int n) {
+    for (int i = 1; i <= n; ++i) YieldWith(i);
+    return {};
+}
+
+Generating<std::string> Names() {
+    for (const char *name : {"ada", "bob", "cyd", "dee"}) {
+        YieldWith(std::string(name));
+    }
+    return {};
+}
+
+int main() {
+    // five adapters, one coroutine
+    auto odd = [](int i) { return i % 2 == 1; };
+    auto square = [](int i) { return i * i; };
+    for (auto &[i, sq] : Conjure(Config{}, Naturals, 100) | gen::Filter(odd) |
+                             gen::Map(square) | gen::Take(5) |
+                             gen::Enumerate()) {
+        printf("%zu: %d\n", i, sq);
+    }
+
+    for (auto &[id, name] :
+         gen::Zip(Conjure(Config{}, Naturals, 10), Conjure(Config{}, Names))) {
+        printf("%d -> %s\n", id, name.c_str());
+    }
+
+    for (const std::vector<int> &row :
+         Conjure(Config{}, Naturals, 10) | gen::Chunk(4)) {
+        for (int i : row) printf(" %d", i);
+        putchar('\n');
+    }
+
+    // each value expands into a generator or a container
+    for (int i : Conjure(Config{}, Naturals, 3) | gen::FlatMap([](int n) {
+                     return Conjure(Config{}, Naturals, n);
+                 })) {
+        printf(" %d", i);
+    }
+    putchar('\n');
+    auto repeat = [](int n) { return std::vector<int>(n, n); };
+    for (int i : Conjure(Config{}, Naturals, 3) | gen::FlatMap(repeat)) {
+        printf(" %d", i);
+    }
+    putchar('\n');
+
+    // views start from the plain begin()/end() iteration too
+    auto co = Conjure(Config{}, Naturals, 3);
+    for (int i : gen::From(co) | gen::Map([](int i) { return -i; })) {
+        printf(" %d", i);
+    }
+    putchar('\n');
+}
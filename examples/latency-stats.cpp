@@ -0,0 +1,46 @@
+#include "conjure/interfaces.h"
+#include "conjure/io/interfaces.h"
+#include "conjure/offload.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+using namespace conjure;
+
+void Reader(int fd, int rounds) {
+    char buffer[4096];
+    for (int i = 0; i < rounds; ++i) {
+        io::Pread(fd, buffer, sizeof(buffer), 0);
+    }
+}
+
+void PrintStage(const char *name, const io::StageSnapshot &s) {
+    printf("  %-8s n=%-6lu p50=%-8.1f p99=%-8.1f max=%.1f (us)\n", name,
+           s.count, s.p50 / 1e3, s.p99 / 1e3, s.max / 1e3);
+}
+
+int main(int argc, char *argv[]) {
+    int rounds = argc > 1 ? atoi(argv[1]) : 20;
+    io::EnableLatencyTracking();
+
+    int fd = io::Open("/dev/zero", O_RDONLY);
+    auto a = Conjure(Config{}, Reader, fd, rounds);
+    auto b = Conjure(Config{}, Reader, fd, rounds);
+    Resume(a);
+    Resume(b);
+    Wait(a);
+    Wait(b);
+    io::Close(fd);
+
+    // both land in one "OffloadJob" entry, n=2
+    Offload([] { return 1; });
+    Offload([](int n) { return n * 2; }, 21);
+
+    for (const io::OpLatencySnapshot &op : io::LatencySnapshot()) {
+        printf("%s\n", op.op.c_str());
+        PrintStage("queue", op[io::LatencyStage::kQueue]);
+        PrintStage("syscall", op[io::LatencyStage::kSyscall]);
+        PrintStage("resume", op[io::LatencyStage::kResume]);
+        PrintStage("total", op[io::LatencyStage::kTotal]);
+    }
+}
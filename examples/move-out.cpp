@@ -0,0 +1,91 @@
+// Consumers may keep generated values without copying them: values yielded
+// as rvalues are moved out, values the producer still owns are copied.
+
+#include "conjure/gen-iterator.h"
+#include "conjure/interfaces.h"
+#include <stdio.h>
+#include <vector>
+
+using namespace conjure;
+
+struct Noise {
+    Noise(int v) : val(v) {
+        printf("Noise %d construct\n", val);
+    }
+    Noise(const Noise &n) {
+        val = n.val;
+        printf("Noise %d copy\n", val);
+    }
+    Noise(Noise &&n) {
+        val = n.val;
+        printf("Noise %d move\n", val);
+    }
+    ~Noise() {
+        printf("Noise %d destruct\n", val);
+    }
+    int val;
+};
+
+Generating<Noise> Temporaries(int n) {
+    for (int i = 0; i < n; ++i) {
+        YieldWith(Noise{i});
+    }
+    return {};
+}
+
+// keeps reusing the same object, so consumers get copies
+Generating<Noise> Reused(int n) {
+    Noise noise(100);
+    for (int i = 0; i < n; ++i) {
+        noise.val = 100 + i;
+        YieldWith(noise);
+    }
+    return {};
+}
+
+// a pipeline stage passing the values on without copies
+Generating<Noise> Doubled(ConjuryClient<Generating<Noise>> *src) {
+    for (Noise n : Moving(src)) {
+        n.val *= 2;
+        YieldWith(std::move(n));
+    }
+    return {};
+}
+
+Generating<Noise> Delegating() {
+    YieldFrom(Conjure(Config{}, Temporaries, 1));
+    return {};
+}
+
+int main() {
+    std::vector<Noise> kept;
+    kept.reserve(8);
+
+    printf("-- temporaries are moved\n");
+    for (Noise n : Moving(Conjure(Config{}, Temporaries, 2))) {
+        kept.push_back(std::move(n));
+    }
+
+    printf("-- reused objects are copied\n");
+    auto reused = Conjure(Config{}, Reused, 2);
+    for (;;) {
+        std::optional<Noise> n = TakeValue(reused);
+        if (not n) break;
+        kept.push_back(std::move(*n));
+    }
+
+    printf("-- through a stage\n");
+    for (Noise n : Moving(
+             Conjure(Config{}, Doubled, Conjure(Config{}, Temporaries, 2)))) {
+        kept.push_back(std::move(n));
+    }
+
+    printf("-- through YieldFrom\n");
+    for (Noise n : Moving(Conjure(Config{}, Delegating))) {
+        kept.push_back(std::move(n));
+    }
+
+    printf("-- kept:");
+    for (const Noise &n : kept) printf(" %d", n.val);
+    printf("\n");
+}
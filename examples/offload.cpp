@@ -0,0 +1,50 @@
+#include "conjure/interfaces.h"
+#include "conjure/offload.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdexcept>
+#include <string>
+
+using namespace conjure;
+
+uint64_t Fnv1a(const std::string &data, int rounds) {
+    uint64_t h = 14695981039346656037ull;
+    for (int r = 0; r < rounds; ++r) {
+        for (unsigned char c : data) h = (h ^ c) * 1099511628211ull;
+    }
+    return h;
+}
+
+void Hasher() {
+    std::string data(1 << 16, 'x');
+    // the scheduler keeps running other coroutines meanwhile
+    uint64_t h = Offload(Fnv1a, data, 200);
+    printf("hash: %016lx\n", (unsigned long)h);
+}
+
+void Ticker() {
+    for (int i = 0; i < 3; ++i) {
+        printf("tick %d\n", i);
+        Yield();
+    }
+}
+
+int main() {
+    auto hasher = Conjure(Config{"hasher"}, Hasher);
+    auto ticker = Conjure(Config{"ticker"}, Ticker);
+    Resume(hasher);
+    Resume(ticker);
+    Wait(hasher);
+    Wait(ticker);
+
+    try {
+        Offload([]() -> int { throw std::runtime_error("parse error"); });
+    } catch (const std::exception &e) {
+        printf("rethrown: %s\n", e.what());
+    }
+
+    // arguments are passed by reference, nothing is copied
+    int n = 21;
+    Offload([](int &n) { n *= 2; }, n);
+    printf("n: %d\n", n); // 42
+}
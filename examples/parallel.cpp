@@ -0,0 +1,72 @@
+#include "conjure/io/interfaces.h"
+#include "conjure/parallel.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <list>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace conjure;
+using namespace std::chrono_literals;
+
+int main() {
+    // 1000 slow lookups, at most 100 at a time, on 100 worker stacks
+    std::vector<int> ids(1000);
+    std::iota(ids.begin(), ids.end(), 0);
+    auto start = std::chrono::steady_clock::now();
+    int in_flight = 0, peak = 0;
+    ParallelForEach(
+        ids,
+        [&](int) {
+            peak = std::max(peak, ++in_flight);
+            SleepFor(5ms);
+            --in_flight;
+        },
+        100);
+    std::chrono::duration<double, std::milli> took =
+        std::chrono::steady_clock::now() - start;
+    printf("1000 x 5ms in %.0f ms, at most %d in flight\n", took.count(), peak);
+
+    // any range with begin/end, here not random access
+    std::list<std::string> words{"bounded", "concurrency", "over", "ranges"};
+    size_t letters = ParallelReduce(
+        words, size_t(0), [](const std::string &w) { return w.size(); },
+        std::plus<size_t>(), 3);
+    printf("%zu letters\n", letters);
+
+    // spread over two threads, each with a scheduler of its own
+    ParallelConfig config;
+    config.concurrency = 8;
+    config.threads = 2;
+    long sum = ParallelReduce(
+        ids, 0L, [](int i) { return (long)i * i; }, std::plus<long>(), config);
+    printf("sum of squares: %ld\n", sum);
+
+    // both threads submit I/O jobs to the shared worker pool
+    int fd = open("/dev/zero", O_RDONLY);
+    std::atomic<long> bytes = 0;
+    ParallelForEach(
+        ids,
+        [&](int) {
+            char buffer[64];
+            bytes += io::Read(fd, buffer, sizeof(buffer));
+        },
+        config);
+    close(fd);
+    printf("read %ld bytes on two threads\n", bytes.load());
+
+    try {
+        ParallelForEach(ids, [](int i) {
+            if (i == 10) throw std::runtime_error("item 10 failed");
+            Yield();
+        });
+    } catch (const std::exception &e) {
+        printf("stopped: %s\n", e.what());
+    }
+}
@@ -0,0 +1,40 @@
+#include "conjure/interfaces.h"
+#include "conjure/io/interfaces.h"
+#include <stdio.h>
+#include <sys/uio.h>
+#include <vector>
+
+using namespace conjure;
+
+// Several coroutines read disjoint records of one shared fd at explicit
+// offsets, none of them touches the file offset.
+void ReadRecord(int fd, int index) {
+    char key[4], value[8];
+    struct iovec iov[2] = {{key, sizeof(key)}, {value, sizeof(value)}};
+    ssize_t n = io::Preadv(fd, iov, 2, (off_t)index * 12);
+    printf("record %d: %zd bytes, %.4s=%.8s\n", index, n, key, value);
+}
+
+int main() {
+    int fd = io::Open("./records.txt", O_CREAT | O_TRUNC | O_RDWR);
+    if (fd == -1) {
+        puts("error open file");
+        return 1;
+    }
+    const char *keys[] = {"key0", "key1", "key2"};
+    const char *values[] = {"value000", "value111", "value222"};
+    for (int i = 0; i < 3; ++i) {
+        struct iovec iov[2] = {{(void *)keys[i], 4}, {(void *)values[i], 8}};
+        io::Pwritev(fd, iov, 2, (off_t)i * 12);
+    }
+
+    std::vector<Conjury *> readers;
+    for (int i = 2; i >= 0; --i) {
+        readers.push_back(Conjure(Config{}, ReadRecord, fd, i));
+    }
+    for (auto r : readers) Resume(r);
+    for (auto r : readers) Wait(r);
+
+    char whole[37] = {};
+    printf("pread: %zd bytes %s\n", io::Pread(fd, whole, 36, 0), whole);
+}
@@ -0,0 +1,58 @@
+#include "conjure/prefetch.h"
+#include <stdio.h>
+#include <stdexcept>
+#include <string>
+
+using namespace conjure;
+
+// an ordinary generator, unaware of where it runs
+Generating<std::string> Lines(int n) {
+    for (int i = 0; i < n; ++i) {
+        YieldWith("line " + std::to_string(i));
+    }
+    return {};
+}
+
+Generating<std::string> Broken(int n) {
+    for (int i = 0; i < n; ++i) {
+        YieldWith("line " + std::to_string(i));
+    }
+    throw std::runtime_error("disk gone");
+}
+
+int main() {
+    PrefetchConfig prefetch;
+    prefetch.depth = 4;
+
+    size_t bytes = 0;
+    for (const std::string &line : Prefetch(Config{}, prefetch, Lines, 10)) {
+        printf("%s\n", line.c_str());
+        bytes += line.size();
+    }
+    printf("%zu bytes\n", bytes);
+
+    // values can be moved out as from any generator
+    std::optional<std::string> last;
+    for (std::string line : Moving(Prefetch(Config{}, {}, Lines, 1000))) {
+        last = std::move(line);
+    }
+    printf("last: %s\n", last->c_str());
+
+    // stopping early leaves the producer blocked until this thread exits
+    auto endless = Prefetch(Config{}, prefetch, Lines, 1 << 20);
+    for (const std::string &line : endless) {
+        if (line == "line 2") {
+            break;
+        }
+    }
+
+    // what the producer throws comes out of the loop after its values
+    try {
+        auto broken = Prefetch(Config{}, prefetch, Broken, 2);
+        for (const std::string &line : broken) {
+            printf("%s\n", line.c_str());
+        }
+    } catch (const std::runtime_error &e) {
+        printf("failed: %s\n", e.what());
+    }
+}
@@ -0,0 +1,70 @@
+#include "conjure/interfaces.h"
+#include "conjure/io/interfaces.h"
+#include "conjure/select.h"
+#include <stdio.h>
+#include <unistd.h>
+#include <chrono>
+#include <string>
+
+using namespace conjure;
+using namespace std::chrono_literals;
+
+void Ticker(Channel<int> *ticks) {
+    for (int i = 0; i < 3; ++i) {
+        SleepFor(10ms);
+        ticks->Send(i);
+    }
+}
+
+void Slow() {
+    SleepFor(50ms);
+}
+
+int main() {
+    Channel<int> ticks;
+    Channel<std::string> messages;
+    auto ticker = Conjure(Config{"ticker"}, Ticker, &ticks);
+    auto slow = Conjure(Config{"slow"}, Slow);
+    Resume(ticker);
+    Resume(slow);
+
+    // channels against a child's finish
+    for (bool done = false; not done;) {
+        std::optional<int> tick;
+        std::optional<std::string> message;
+        Select select;
+        int got_tick = select.Recv(ticks, tick);
+        select.Recv(messages, message);
+        int slow_done = select.Finish(slow);
+        int got = select.Wait();
+        if (got == got_tick) {
+            printf("tick %d\n", *tick);
+        } else if (got == slow_done) {
+            puts("slow finished");
+            done = true;
+        }
+    }
+    Wait(ticker);
+    Wait(slow);
+
+    // an io job against a timer
+    int pipe_fds[2];
+    pipe(pipe_fds);
+    char buffer[16] = {};
+    io::job::Read read(pipe_fds[0], buffer, sizeof(buffer) - 1);
+    Select first;
+    int read_done = first.Complete(read);
+    int timeout = first.Timeout(20ms);
+    printf("timed out: %d\n", first.Wait() == timeout);
+
+    // the read kept running, select on it again once there's data
+    io::Write(pipe_fds[1], "data");
+    Select second;
+    read_done = second.Complete(read);
+    second.Timeout(1s);
+    if (second.Wait() == read_done) {
+        printf("read %d: %s\n", read.ReturnValue(), buffer);
+    }
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+}
@@ -0,0 +1,58 @@
+#include "conjure/interfaces.h"
+#include "conjure/sync.h"
+#include <stdio.h>
+#include <mutex>
+#include <queue>
+#include <vector>
+
+using namespace conjure;
+
+Mutex mutex;
+ConditionVariable not_empty;
+std::queue<int> jobs;
+bool closed = false;
+
+WaitGroup workers_done;
+Semaphore slots(2);
+
+void Worker(int id) {
+    for (;;) {
+        std::unique_lock<Mutex> hold(mutex);
+        not_empty.Wait(hold, []() { return not jobs.empty() or closed; });
+        if (jobs.empty()) break;
+        int job = jobs.front();
+        jobs.pop();
+        hold.unlock();
+
+        // at most two workers in here at a time
+        slots.Acquire();
+        printf("worker %d: job %d\n", id, job);
+        Yield();
+        slots.Release();
+    }
+    workers_done.Done();
+}
+
+int main() {
+    std::vector<Conjury *> workers;
+    for (int i = 0; i < 3; ++i) {
+        workers.push_back(Conjure(Config{}, Worker, i));
+        workers_done.Add();
+    }
+    for (auto w : workers) Resume(w);
+
+    for (int job = 1; job <= 6; ++job) {
+        std::lock_guard<Mutex> hold(mutex);
+        jobs.push(job);
+        not_empty.NotifyOne();
+    }
+    {
+        std::lock_guard<Mutex> hold(mutex);
+        closed = true;
+        not_empty.NotifyAll();
+    }
+
+    workers_done.Wait();
+    puts("all workers done");
+    for (auto w : workers) Wait(w);
+}
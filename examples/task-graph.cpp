@@ -0,0 +1,55 @@
+// fetch a and b, join them on the compute pool, then fetch c
+#include "conjure/task-graph.h"
+#include <stdio.h>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+using namespace conjure;
+using namespace std::chrono_literals;
+
+std::string Fetch(std::string key, std::chrono::milliseconds latency) {
+    SleepFor(latency);
+    return key + "-value";
+}
+
+std::string Join(const std::string &a, const std::string &b) {
+    std::this_thread::sleep_for(15ms); // stands in for real work
+    return a + "+" + b;
+}
+
+size_t FetchBy(const std::string &key) {
+    SleepFor(10ms);
+    return key.size();
+}
+
+double Ms(TaskClock::duration d) {
+    return std::chrono::duration<double, std::milli>(d).count();
+}
+
+int main() {
+    TaskGraph graph;
+    auto a = graph.Add("fetch a", Fetch, std::string("a"), 30ms);
+    auto b = graph.Add("fetch b", Fetch, std::string("b"), 20ms);
+    auto j = graph.AddCpu("join", Join, a, b);
+    auto c = graph.Add("fetch c", FetchBy, j);
+    // independent of the chain above, runs alongside it
+    auto d = graph.Add("fetch d", Fetch, std::string("d"), 40ms);
+    graph.Run();
+
+    printf("%s -> %zu, %s\n", graph.Result(j).c_str(), graph.Result(c),
+           graph.Result(d).c_str());
+    printf("elapsed %.1f ms, critical path:\n", Ms(graph.Elapsed()));
+    for (const CriticalStep &s : graph.CriticalPath()) {
+        printf("  %-8s waited %5.1f ms, ran %5.1f ms\n", s.name.c_str(),
+               Ms(s.wait), Ms(s.run));
+    }
+
+    // edges only point back to nodes added earlier, no cycle can form
+    try {
+        graph.Depend(a, d);
+    } catch (const std::invalid_argument &e) {
+        printf("rejected: %s\n", e.what());
+    }
+}
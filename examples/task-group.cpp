@@ -0,0 +1,74 @@
+#include "conjure/task-group.h"
+#include <stdio.h>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+
+using namespace conjure;
+using namespace std::chrono_literals;
+
+int Length(std::string s, std::chrono::milliseconds delay) {
+    SleepFor(delay);
+    printf("measured %s\n", s.c_str());
+    return s.size();
+}
+
+void Check(int i) {
+    if (i == 2) {
+        throw std::runtime_error("check 2 failed");
+    }
+    Yield();
+    printf("check %d passed\n", i);
+}
+
+int main() {
+    {
+        TaskGroup<int> group;
+        group.Spawn(Config{}, Length, "conjure", 30ms);
+        group.Spawn(Config{}, Length, "task", 10ms);
+        group.Spawn(Config{}, Length, "group", 20ms);
+        // results come in spawn order whatever the finishing order
+        for (int n : group.WaitAll()) printf("%d ", n);
+        printf("\n");
+    }
+
+    {
+        TaskGroup<int> group;
+        group.Spawn(Config{}, Length, "slow", 50ms);
+        int fast = group.Spawn(Config{}, Length, "fast", 5ms);
+        int first = group.WaitAny();
+        printf("first: %d (fast is %d) -> %d\n", first, fast,
+               *group.Result(first));
+        // the group waits for the slow one on its way out
+    }
+
+    {
+        TaskGroup<> group;
+        for (int i = 0; i < 5; ++i) group.Spawn(Config{}, Check, i);
+        try {
+            group.WaitAll();
+        } catch (const std::exception &e) {
+            // checks that hadn't started never run
+            printf("failed: %s\n", e.what());
+        }
+    }
+
+    {
+        TaskGroup<int> group;
+        group.Spawn(Config{}, Length, "never", 1ms);
+        group.Cancel();
+        try {
+            group.WaitAll();
+        } catch (const GroupCancelled &e) {
+            printf("cancelled: %s\n", e.what());
+        }
+    }
+
+    {
+        TaskGroup<int> group;
+        group.Spawn(Config{}, Length, "late", 5ms);
+        // a stray wake-up doesn't end the wait early
+        ActiveConjury()->Wake();
+        printf("late: %d\n", group.WaitAll()[0]);
+    }
+}
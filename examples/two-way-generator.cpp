@@ -0,0 +1,79 @@
+// A decoder fed with pieces of a stream as they arrive, yielding what each
+// piece completes. Nothing goes through a side channel and the pieces are
+// not copied unless a line spans two of them.
+
+#include "conjure/chunked.h"
+#include "conjure/interfaces.h"
+#include <stdio.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace conjure;
+
+using Lines = Chunk<std::string_view>;
+
+// An empty piece ends the stream.
+Generating<Lines, std::string_view> SplitLines() {
+    std::string carry; // start of a line cut by the end of a piece
+    std::string joined;
+    std::vector<std::string_view> lines;
+    std::string_view piece = Received<std::string_view>();
+    for (; not piece.empty();) {
+        lines.clear();
+        size_t start = 0;
+        for (size_t nl; (nl = piece.find('\n', start)) != piece.npos;
+             start = nl + 1) {
+            if (start == 0 and not carry.empty()) {
+                joined = carry;
+                joined.append(piece.substr(0, nl));
+                carry.clear();
+                lines.push_back(joined);
+            } else {
+                lines.push_back(piece.substr(start, nl - start));
+            }
+        }
+        carry.append(piece.substr(start));
+        piece = YieldWith<std::string_view>(Lines{lines.data(), lines.size()});
+    }
+    std::string_view last = carry;
+    YieldWith<std::string_view>(Lines{&last, last.empty() ? 0u : 1u});
+    return {};
+}
+
+// Received() returns the same value until the generator yields
+Generating<int, int> Doubled() {
+    for (int n = Received<int>(); n != 0;) {
+        YieldWith<int>(n + Received<int>());
+        n = Received<int>();
+    }
+    return {};
+}
+
+int main() {
+    std::string_view pieces[] = {
+        "GET / HTTP/1.1\nHo", "st: example.com\n", "Accept: */*\nUser-Ag",
+        "ent: ", "conjure\n\ntrailing"};
+
+    auto decoder = Conjure(Config{}, SplitLines);
+    for (std::string_view piece : pieces) {
+        GenMoveNext(decoder, piece);
+        for (std::string_view line : *decoder->GetGenPtr()) {
+            printf("[%.*s]\n", (int)line.size(), line.data());
+        }
+    }
+    // the end of the stream flushes the last line
+    for (; GenMoveNext(decoder, std::string_view());) {
+        for (std::string_view line : *decoder->GetGenPtr()) {
+            printf("[%.*s]\n", (int)line.size(), line.data());
+        }
+    }
+
+    auto doubled = Conjure(Config{}, Doubled);
+    for (int n : {1, 2, 3}) {
+        GenMoveNext(doubled, n);
+        printf("%d ", *doubled->GetGenPtr()); // 2 4 6
+    }
+    putchar('\n');
+    GenMoveNext(doubled, 0);
+}
@@ -0,0 +1,36 @@
+#include "conjure/interfaces.h"
+#include "conjure/io/interfaces.h"
+#include <stdio.h>
+#include <unistd.h>
+
+using namespace conjure;
+
+void PrintPlacement(const char *what, const ThreadConfig &t) {
+    printf("%s: %s on cpus", what, t.name.c_str());
+    for (int cpu : t.cpus) printf(" %d", cpu);
+    puts("");
+}
+
+int main() {
+    // before anything touches the pool or the scheduler
+    io::PoolConfig pool(2, "demo-io");
+    pool.affinity = {{0}};
+    io::WorkerPool::Configure(pool);
+    Conjurer::Configure(ThreadConfig("demo-sched", {0}));
+
+    int fd = io::Open("/dev/zero", O_RDONLY);
+    char buffer[16];
+    io::Read(fd, buffer, sizeof(buffer));
+    close(fd);
+
+    // too late, both are running
+    printf("reconfigure: %d %d\n", io::WorkerPool::Configure(io::PoolConfig(8)),
+           Conjurer::Configure(ThreadConfig("other")));
+
+    io::WorkerPool &workers = io::WorkerPool::Instance();
+    printf("workers: %d\n", workers.Size());
+    for (int i = 0; i < workers.Size(); ++i) {
+        PrintPlacement("worker", workers.GetWorker(i).Placement());
+    }
+    PrintPlacement("scheduler", ThreadConfig::OfCurrent());
+}
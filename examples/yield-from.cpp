@@ -0,0 +1,62 @@
+#include "conjure/gen-iterator.h"
+#include "conjure/interfaces.h"
+#include <stdio.h>
+#include <memory>
+
+using namespace conjure;
+
+struct Node {
+    int value;
+    std::unique_ptr<Node> left, right;
+};
+
+std::unique_ptr<Node> Insert(std::unique_ptr<Node> n, int v) {
+    if (n == nullptr) return std::make_unique<Node>(Node{v, nullptr, nullptr});
+    auto &side = v < n->value ? n->left : n->right;
+    side = Insert(std::move(side), v);
+    return n;
+}
+
+// In order. Values from the subtrees reach the consumer directly, however
+// deep they are, instead of being yielded again by every level.
+Generating<int> Walk(const Node *n) {
+    if (n->left) YieldFrom(Conjure(Config{}, Walk, n->left.get()));
+    YieldWith(n->value);
+    if (n->right) YieldFrom(Conjure(Config{}, Walk, n->right.get()));
+    return {};
+}
+
+Generating<int> Range(int from, int to) {
+    for (int i = from; i < to; ++i) YieldWith(i);
+    return {};
+}
+
+Generating<int> Ranges(int n) {
+    YieldFrom(Conjure(Config{}, Range, 0, n));
+    YieldFrom(Conjure(Config{}, Range, n, 2 * n));
+    return {};
+}
+
+// Advances `child` itself before handing the rest over, by then the child
+// delegates to its second range.
+Generating<int> Skip(int n, ConjuryClient<Generating<int>> *child) {
+    for (int i = 0; i < n; ++i) GenMoveNext(child);
+    YieldFrom(child);
+    return {};
+}
+
+int main() {
+    std::unique_ptr<Node> root;
+    for (int v : {5, 3, 8, 1, 4, 7, 9, 2, 6}) root = Insert(std::move(root), v);
+
+    for (int v : Conjure(Config{}, Walk, root.get())) {
+        printf("%d ", v); // 1 2 3 4 5 6 7 8 9
+    }
+    putchar('\n');
+
+    auto ranges = Conjure(Config{}, Ranges, 3);
+    for (int v : Conjure(Config{}, Skip, 4, ranges)) {
+        printf("%d ", v); // 4 5
+    }
+    putchar('\n');
+}
@@ -0,0 +1,193 @@
+#ifndef CONJURE_CHANNEL_H_
+#define CONJURE_CHANNEL_H_
+
+#include "conjure/interfaces.h"
+#include "conjure/select-state.h"
+#include "conjure/wait-list.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <deque>
+#include <optional>
+#include <utility>
+
+namespace conjure {
+
+// A typed queue between coroutines of one scheduler. A bounded channel holds
+// at most `capacity` values, senders beyond that park until there is room; a
+// capacity of 0 makes every send wait for a receiver. Parked coroutines wait
+// in the channel's own FIFO lists and are woken directly, the scheduler never
+// polls them. A value sent to a parked receiver is moved straight into it.
+template <typename T>
+class Channel {
+  public:
+    static constexpr size_t kUnbounded = SIZE_MAX;
+
+    // A parked sender or receiver. Waiters of a Select are skipped once
+    // another of its sources won.
+    struct Waiter {
+        bool Claim() {
+            return select == nullptr or select->TryClaim(index);
+        }
+
+        Conjury *conjury = ActiveConjury();
+        T *value = nullptr;                // a parked sender's value
+        std::optional<T> *slot = nullptr;  // a parked receiver's result
+        bool done = false;
+
+        detail::SelectState *select = nullptr;
+        int index = 0;
+
+        Waiter *prev = nullptr;
+        Waiter *next = nullptr;
+    };
+
+    explicit Channel(size_t capacity = kUnbounded) : capacity_(capacity) {}
+
+    Channel(const Channel &) = delete;
+    Channel &operator=(const Channel &) = delete;
+
+    ~Channel() {
+        Close();
+    }
+
+    // Returns false if the channel is or gets closed before the value was
+    // taken, the value is dropped then.
+    template <typename U>
+    bool Send(U &&value) {
+        if (TrySend(std::forward<U>(value))) {
+            return true;
+        }
+        if (closed_) {
+            return false;
+        }
+        T pending(std::forward<U>(value));
+        Waiter w;
+        w.value = &pending;
+        senders_.PushBack(&w);
+        // whoever serves or closes unlinks `w` first, other wake-ups don't
+        for (; senders_.Contains(&w);) {
+            Suspend();
+        }
+        return w.done;
+    }
+
+    // Returns nothing once the channel is closed and drained.
+    std::optional<T> Recv() {
+        std::optional<T> value = TryRecv();
+        if (value or closed_) {
+            return value;
+        }
+        Waiter w;
+        w.slot = &value;
+        receivers_.PushBack(&w);
+        for (; receivers_.Contains(&w);) {
+            Suspend();
+        }
+        return value;
+    }
+
+    // doesn't touch `value` unless it was sent
+    template <typename U>
+    bool TrySend(U &&value) {
+        if (closed_) {
+            return false;
+        }
+        if (Waiter *r = PopClaimed(receivers_)) {
+            r->slot->emplace(std::forward<U>(value));
+            Hand(r);
+            return true;
+        }
+        if (buffer_.size() < capacity_) {
+            buffer_.emplace_back(std::forward<U>(value));
+            return true;
+        }
+        return false;
+    }
+
+    std::optional<T> TryRecv() {
+        std::optional<T> value;
+        if (not buffer_.empty()) {
+            value.emplace(std::move(buffer_.front()));
+            buffer_.pop_front();
+            // room for the longest waiting sender
+            if (Waiter *s = PopClaimed(senders_)) {
+                buffer_.emplace_back(std::move(*s->value));
+                Hand(s);
+            }
+        } else if (Waiter *s = PopClaimed(senders_)) {
+            value.emplace(std::move(*s->value));
+            Hand(s);
+        }
+        return value;
+    }
+
+    // Wakes everyone parked: senders fail, receivers get nothing. Buffered
+    // values can still be received.
+    void Close() {
+        if (closed_) {
+            return;
+        }
+        closed_ = true;
+        for (; Waiter *w = PopClaimed(senders_);) {
+            w->conjury->Wake();
+        }
+        for (; Waiter *w = PopClaimed(receivers_);) {
+            w->conjury->Wake();
+        }
+    }
+
+    // Parks a waiter without suspending, for waiting on several sources.
+    // `w` gets a value or the channel's closing, whichever comes first.
+    void ParkSender(Waiter *w) {
+        senders_.PushBack(w);
+    }
+
+    void ParkReceiver(Waiter *w) {
+        receivers_.PushBack(w);
+    }
+
+    // no-op if `w` was already served
+    void Unpark(Waiter *w) {
+        auto &list = w->value != nullptr ? senders_ : receivers_;
+        if (list.Contains(w)) {
+            list.Remove(w);
+        }
+    }
+
+    bool Closed() const {
+        return closed_;
+    }
+
+    size_t Size() const {
+        return buffer_.size();
+    }
+
+    size_t Capacity() const {
+        return capacity_;
+    }
+
+  private:
+    static Waiter *PopClaimed(detail::WaitList<Waiter> &list) {
+        for (; Waiter *w = list.PopFront();) {
+            if (w->Claim()) {
+                return w;
+            }
+        }
+        return nullptr;
+    }
+
+    static void Hand(Waiter *w) {
+        w->done = true;
+        w->conjury->Wake();
+    }
+
+    size_t capacity_;
+    bool closed_ = false;
+    std::deque<T> buffer_;
+    detail::WaitList<Waiter> senders_;
+    detail::WaitList<Waiter> receivers_;
+};
+
+} // namespace conjure
+
+#endif // CONJURE_CHANNEL_H_
@@ -0,0 +1,151 @@
+#ifndef CONJURE_CHUNKED_H_
+#define CONJURE_CHUNKED_H_
+
+#include "conjure/gen-iterator.h"
+#include "conjure/interfaces.h"
+#include <stddef.h>
+#include <exception>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace conjure {
+
+// A run of generated values, valid until the generator is resumed.
+template <typename G>
+struct Chunk {
+    const G *begin() const {
+        return data;
+    }
+    const G *end() const {
+        return data + size;
+    }
+
+    const G *data = nullptr;
+    size_t size = 0;
+};
+
+// Hands `n` values to the consumer in one switch, without copying them.
+template <typename G>
+void YieldMany(const G *data, size_t n) {
+    if (n > 0) {
+        YieldWith(Chunk<G>{data, n});
+    }
+}
+
+template <typename Container>
+void YieldMany(const Container &c) {
+    YieldMany(std::data(c), std::size(c));
+}
+
+// Buffers values emitted by a Generating<Chunk<G>> and switches to the
+// consumer only once `capacity` of them are collected. The rest is handed
+// over by Flush() or when the emitter goes out of scope.
+template <typename G>
+class Emitter {
+  public:
+    explicit Emitter(size_t capacity = 256) : capacity_(capacity) {
+        buffer_.reserve(capacity_);
+    }
+
+    Emitter(const Emitter &) = delete;
+    Emitter &operator=(const Emitter &) = delete;
+
+    ~Emitter() {
+        if (std::uncaught_exceptions() == 0) {
+            Flush();
+        }
+    }
+
+    template <typename U>
+    void Emit(U &&u) {
+        buffer_.emplace_back(std::forward<U>(u));
+        if (buffer_.size() == capacity_) {
+            Flush();
+        }
+    }
+
+    void Flush() {
+        YieldMany(buffer_.data(), buffer_.size());
+        buffer_.clear();
+    }
+
+  private:
+    size_t capacity_;
+    std::vector<G> buffer_;
+};
+
+// Iterates the values of a chunked generator one by one, switching to the
+// producer only when a chunk is used up.
+template <typename G>
+struct ChunkedIterator {
+    using Self = ChunkedIterator;
+    using value_type = G;
+    using reference_type = const G &;
+    using pointer = const G *;
+    using iterator_category = std::input_iterator_tag;
+
+    explicit ChunkedIterator(ConjuryClient<Generating<Chunk<G>>> *conjure)
+        : conjure(conjure) {}
+
+    const G &operator*() const {
+        return *current;
+    }
+
+    const G *operator->() const {
+        return current;
+    }
+
+    Self &operator++() {
+        if (current != nullptr and ++current != chunk_end) {
+            return *this;
+        }
+        current = nullptr;
+        for (; GenMoveNext(conjure);) {
+            const Chunk<G> *chunk = conjure->GetGenPtr();
+            if (chunk->size > 0) {
+                current = chunk->data;
+                chunk_end = chunk->data + chunk->size;
+                break;
+            }
+        }
+        return *this;
+    }
+
+    bool operator==(GenIterEnd) const {
+        return current == nullptr;
+    }
+
+    bool operator!=(GenIterEnd) const {
+        return current != nullptr;
+    }
+
+    ConjuryClient<Generating<Chunk<G>>> *conjure;
+    const G *current = nullptr;
+    const G *chunk_end = nullptr;
+};
+
+template <typename G>
+struct ChunkedRange {
+    ChunkedIterator<G> begin() const {
+        ChunkedIterator<G> iter(conjure);
+        ++iter;
+        return iter;
+    }
+
+    GenIterEnd end() const {
+        return {};
+    }
+
+    ConjuryClient<Generating<Chunk<G>>> *conjure;
+};
+
+// `for (const G &g : Elements(co))` walks the chunks of `co` value by value
+template <typename G>
+ChunkedRange<G> Elements(ConjuryClient<Generating<Chunk<G>>> *co) {
+    return {co};
+}
+
+} // namespace conjure
+
+#endif // CONJURE_CHUNKED_H_
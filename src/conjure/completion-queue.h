@@ -0,0 +1,86 @@
+#ifndef CONJURE_COMPLETION_QUEUE_H_
+#define CONJURE_COMPLETION_QUEUE_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+namespace conjure {
+
+// Multi-producer single-consumer intrusive queue. Any thread may push, only
+// the owner drains, and the owner may block until something is pushed. T
+// must provide a `T *completion_next_` member and befriend this class.
+template <typename T>
+class CompletionQueue {
+  public:
+    void Push(T *t) {
+        T *head = head_.load(std::memory_order_relaxed);
+        do {
+            t->completion_next_ = head;
+        } while (not head_.compare_exchange_weak(
+            head, t, std::memory_order_seq_cst, std::memory_order_relaxed));
+        // the owner flags itself before its last look at the queue
+        if (sleeping_.load(std::memory_order_seq_cst)) {
+            std::lock_guard<std::mutex> lock(mu_);
+            cv_.notify_one();
+        }
+    }
+
+    bool Empty() const {
+        return head_.load(std::memory_order_relaxed) == nullptr;
+    }
+
+    // blocks the owner until something is pushed
+    void Wait() {
+        std::unique_lock<std::mutex> lock(mu_);
+        sleeping_.store(true, std::memory_order_seq_cst);
+        cv_.wait(lock, [this] { return Pending(); });
+        sleeping_.store(false, std::memory_order_relaxed);
+    }
+
+    // Wait() giving up at `deadline`
+    template <typename Clock, typename Duration>
+    void WaitUntil(const std::chrono::time_point<Clock, Duration> &deadline) {
+        std::unique_lock<std::mutex> lock(mu_);
+        sleeping_.store(true, std::memory_order_seq_cst);
+        cv_.wait_until(lock, deadline, [this] { return Pending(); });
+        sleeping_.store(false, std::memory_order_relaxed);
+    }
+
+    // takes everything pushed so far and visits it in push order
+    template <typename F>
+    int Drain(F f) {
+        T *head = head_.exchange(nullptr, std::memory_order_acquire);
+        T *reversed = nullptr;
+        for (; head != nullptr;) {
+            T *next = head->completion_next_;
+            head->completion_next_ = reversed;
+            reversed = head;
+            head = next;
+        }
+        int n = 0;
+        for (; reversed != nullptr; ++n) {
+            T *next = reversed->completion_next_;
+            reversed->completion_next_ = nullptr;
+            f(reversed);
+            reversed = next;
+        }
+        return n;
+    }
+
+  private:
+    bool Pending() const {
+        return head_.load(std::memory_order_seq_cst) != nullptr;
+    }
+
+    std::atomic<T *> head_ = nullptr;
+
+    std::atomic<bool> sleeping_ = false;
+    std::mutex mu_;
+    std::condition_variable cv_;
+};
+
+} // namespace conjure
+
+#endif // CONJURE_COMPLETION_QUEUE_H_
@@ -6,9 +6,14 @@
 #include "conjure/exceptions.h"
 #include "conjure/scheduler.h"
 #include "conjure/stage.h"
+#include "conjure/thread-config.h"
+#include <exception>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace conjure {
 
@@ -26,19 +31,42 @@ class Conjurer {
               Config("__scheduler__"), &Scheduler::Run, scheduler_.get())) {
         // printf(
         // "main_co: %p, scheduler: %p\n", active_conjury_, sche_co_.get());
+        stage_.ActiveConjury()->BindCompletionQueue(
+            scheduler_->GetCompletionQueue());
     }
 
+    // One per thread, so threads other than the main one may run
+    // coroutines of their own. They never share a conjury.
     static Conjurer *Instance() {
-        static Conjurer conjurer;
+        static thread_local Conjurer conjurer(ApplySchedulerThreadConfig());
         return &conjurer;
     }
 
+    // Placement and name of the thread running the first scheduler, applied
+    // by the first Instance() call of any thread. Returns false once that
+    // scheduler exists. Threads starting schedulers later place themselves,
+    // e.g. through ParallelConfig::thread.
+    static bool Configure(const ThreadConfig &config) {
+        std::lock_guard<std::mutex> hold(SchedulerConfigLock());
+        if (SchedulerThreadConfig().second) {
+            return false;
+        }
+        SchedulerThreadConfig().first = config;
+        return true;
+    }
+
+    static ThreadConfig GetSchedulerThreadConfig() {
+        std::lock_guard<std::mutex> hold(SchedulerConfigLock());
+        return SchedulerThreadConfig().first;
+    }
+
     template <typename F, typename... Args>
     ConjuryClientT<F, Args...> *
     Conjure(const Config &config, F f, Args &&... args) {
         auto co =
             UnmanagedConjure(config, std::move(f), std::forward<Args>(args)...);
         auto co_client = co.get();
+        co_client->BindCompletionQueue(scheduler_->GetCompletionQueue());
         stage_.Manage(std::move(co));
 
         return co_client;
@@ -50,8 +78,9 @@ class Conjurer {
         if (not WaitAndSwitch(co)) {
             throw InconsistentWait(ActiveConjury(), co);
         }
+        RethrowFailure(co);
         T result = co->UnsafeGetResult();
-        stage_.Destroy(co);
+        Destroy(co);
         return result; // NRVO
     }
 
@@ -60,12 +89,14 @@ class Conjurer {
         if (not WaitAndSwitch(co)) {
             throw InconsistentWait(ActiveConjury(), co);
         }
-        stage_.Destroy(co);
+        RethrowFailure(co);
+        Destroy(co);
     }
 
     void End() {
         Conjury *me = ActiveConjury();
         CONJURE_LOGF("%s ending", me->Name());
+        me->NotifyFinish();
         if (Conjury *target = me->ReturnTarget();
             target != nullptr and target->WaitTarget() == me) {
             // TODO: is this assert correct?
@@ -78,12 +109,12 @@ class Conjurer {
         }
     }
 
+    // Without a predicate the conjury stays suspended until someone calls
+    // Wake() on it, the scheduler never polls it.
     template <typename P = Void>
     void Suspend(P p = P{}) {
         Conjury *current = ActiveConjury();
-        if constexpr (std::is_same_v<P, Void>) {
-            scheduler_->RegisterSuspended(current);
-        } else {
+        if constexpr (not std::is_same_v<P, Void>) {
             scheduler_->RegisterSuspended(current, std::move(p));
         }
         YieldToScheduler(State::kSuspended);
@@ -93,7 +124,9 @@ class Conjurer {
         Conjury *return_target = ActiveConjury()->ReturnTarget();
         scheduler_->RegisterReady(ActiveConjury());
         if (return_target != nullptr and return_target->IsExecutable()) {
-            ForceYieldBack(State::kReady);
+            // the target is ready rather than waiting, ForceYieldBack would
+            // trip on its assertion
+            stage_.UnsafeSwitchTo(return_target, State::kReady);
         } else {
             YieldToScheduler(State::kReady);
         }
@@ -108,10 +141,39 @@ class Conjurer {
         return true;
     }
 
-    template <typename U, typename G = std::decay_t<U>>
-    void YieldWith(U &&u) {
-        GenerateImpl(std::forward<U>(u));
-        ForceYieldBack(State::kReady);
+    // With an `In` the active conjury is a Generating<G, In> and the value
+    // sent with the next GenMoveNext is returned.
+    template <typename In = void, typename U>
+    decltype(auto) YieldWith(U &&u) {
+        if constexpr (std::is_void_v<In>) {
+            GenerateImpl(std::forward<U>(u));
+            ForceYieldBack(State::kReady);
+        } else {
+            using G = std::decay_t<U>;
+            auto gen_co = GetActiveConjuryAs<Generating<G, In>>();
+            if (gen_co == nullptr or gen_co->ReturnTarget() == nullptr) {
+                throw InvalidYieldContext<G>(ActiveConjury());
+            }
+            gen_co->StoreGen(std::forward<U>(u));
+            gen_co->ClearSent();
+            ForceYieldBack(State::kReady);
+            const In *in = gen_co->GetSentPtr();
+            assert(in != nullptr);
+            return *in;
+        }
+    }
+
+    // the value sent to the active two-way generator by the GenMoveNext that
+    // resumed it, valid until it yields
+    template <typename In>
+    const In &Received() {
+        auto receiver = dynamic_cast<detail::Receiver<In> *>(ActiveConjury());
+        if (receiver == nullptr) {
+            throw InvalidYieldContext<In>(ActiveConjury());
+        }
+        const In *in = receiver->GetSentPtr();
+        assert(in != nullptr);
+        return *in;
     }
 
     template <typename U>
@@ -122,24 +184,170 @@ class Conjurer {
         }
     }
 
+    // Switches straight to the innermost generator `gen_co` delegates to,
+    // its values come back without passing the generators in between.
     template <typename G>
     bool GenMoveNext(ConjuryClient<Generating<G>> *gen_co) {
+        for (;;) {
+            ConjuryClient<Generating<G>> *leaf = gen_co->Innermost();
+            ActiveConjury()->WaitTarget(leaf);
+            WaitAndSwitch(leaf);
+            if (leaf == gen_co and gen_co->IsFinished()) {
+                RethrowFailure(gen_co);
+                Destroy(gen_co);
+                return false;
+            }
+            if (ConjuryClient<Generating<G>> *d = leaf->Delegate()) {
+                // it just started delegating, go on with the new leaf, which
+                // delegates itself already if it was advanced before
+                for (; d->Delegate() != nullptr;) {
+                    d = d->Delegate();
+                }
+                gen_co->Innermost(d);
+                continue;
+            }
+            if (leaf == gen_co) {
+                return true;
+            }
+            if (not leaf->IsFinished()) {
+                gen_co->ForwardGen(leaf);
+                return true;
+            }
+            // back to the delegator, which destroys the leaf
+            leaf->Delegator()->Delegate(nullptr);
+            gen_co->Innermost(leaf->Delegator());
+        }
+    }
+
+    // Sends `in` to a two-way generator and runs it up to its next value.
+    // `in` is passed by reference, nothing is copied.
+    template <typename G, typename In>
+    bool GenMoveNext(
+        ConjuryClient<Generating<G, In>> *gen_co,
+        const std::common_type_t<In> &in) {
+        gen_co->StoreSent(in);
         ActiveConjury()->WaitTarget(gen_co);
         WaitAndSwitch(gen_co);
         if (gen_co->IsFinished()) {
-            stage_.Destroy(gen_co);
+            RethrowFailure(gen_co);
+            Destroy(gen_co);
             return false;
         }
         return true;
     }
 
+    // Lets the consumer of the active generator take the values of `child`
+    // directly until it finishes, then returns. The child may have been
+    // advanced by the active generator already, it goes on from there.
+    template <typename G>
+    void YieldFrom(ConjuryClient<Generating<G>> *child) {
+        auto gen_co = GetActiveConjuryAs<Generating<G>>();
+        if (gen_co == nullptr or gen_co->ReturnTarget() == nullptr) {
+            throw InvalidYieldContext<G>(ActiveConjury());
+        }
+        gen_co->Delegate(child);
+        child->Delegator(gen_co);
+        // what we advanced returns to the consumer from now on
+        for (ConjuryClient<Generating<G>> *c = child; c != nullptr;
+             c = c->Delegate()) {
+            if (c->ReturnTarget() == gen_co) {
+                c->ReturnTarget(nullptr);
+            }
+        }
+        // the consumer sees the delegate and resumes us once it finished
+        ForceYieldBack(State::kReady);
+        assert(child->IsFinished());
+        // passed on up the chain, our own caller wrapper catches it
+        RethrowFailure(child);
+        Destroy(child);
+    }
+
     Conjury *ActiveConjury() {
         return stage_.ActiveConjury();
     }
 
+    // Same-thread counterpart of Wake(): puts a conjury parked by Suspend()
+    // without a predicate straight onto the ready queue.
+    void Ready(Conjury *c) {
+        assert(c->GetState() == State::kSuspended);
+        c->UnsafeSetState(State::kReady);
+        scheduler_->RegisterReady(c);
+    }
+
+    // Queues a conjury that never ran to start once the scheduler gets to
+    // it, the active one carries on.
+    void Spawn(Conjury *c) {
+        // stays initial, its first switch is what calls its function
+        assert(c->GetState() == State::kInitial);
+        scheduler_->RegisterReady(c);
+    }
+
+    // frees finished conjuries nobody is going to Wait for
+    void Reclaim(std::vector<const Conjury *> cos) {
+        for (const Conjury *c : cos) {
+            assert(c->IsFinished());
+            scheduler_->Forget(const_cast<Conjury *>(c));
+        }
+        stage_.Destroy(std::move(cos));
+    }
+
+    void AddTimer(detail::Timer *t) {
+        scheduler_->AddTimer(t);
+    }
+
+    bool RemoveTimer(detail::Timer *t) {
+        return scheduler_->RemoveTimer(t);
+    }
+
   private:
+    struct ConfiguredTag {};
+
+    explicit Conjurer(ConfiguredTag) : Conjurer() {}
+
+    static std::mutex &SchedulerConfigLock() {
+        static std::mutex lock;
+        return lock;
+    }
+
+    static std::pair<ThreadConfig, bool> &SchedulerThreadConfig() {
+        static std::pair<ThreadConfig, bool> config;
+        return config;
+    }
+
+    // Runs before the stage is set up so it's allocated on the right node.
+    // Only the first thread building a Conjurer takes the config.
+    static ConfiguredTag ApplySchedulerThreadConfig() {
+        ThreadConfig config;
+        {
+            std::lock_guard<std::mutex> hold(SchedulerConfigLock());
+            if (SchedulerThreadConfig().second) {
+                return {};
+            }
+            SchedulerThreadConfig().second = true;
+            config = SchedulerThreadConfig().first;
+        }
+        if (not config.ApplyToCurrent()) {
+            CONJURE_LOGL("scheduler thread config partly rejected");
+        }
+        return {};
+    }
+
     static std::unique_ptr<Conjurer> instance_;
 
+    // a wake-up still queued for `co` must not outlive it
+    void Destroy(Conjury *co) {
+        scheduler_->Forget(co);
+        stage_.Destroy(co);
+    }
+
+    // destroys a finished `co` and rethrows if its function threw
+    void RethrowFailure(Conjury *co) {
+        if (std::exception_ptr e = co->TakeError()) {
+            Destroy(co);
+            std::rethrow_exception(e);
+        }
+    }
+
     bool WaitAndSwitch(Conjury *co) {
         if (IsWaitedByOthers(co)) {
             return false;
@@ -147,6 +355,8 @@ class Conjurer {
         co->ReturnTarget(ActiveConjury());
         ActiveConjury()->WaitTarget(co);
         SwitchToTargetOrScheduler(co, State::kWaiting);
+        // a finished target never clears it, and its address gets reused
+        ActiveConjury()->WaitTarget(nullptr);
         return true;
     }
 
@@ -1,14 +1,19 @@
 #ifndef CONJURE_CONJURY_H_
 #define CONJURE_CONJURY_H_
 
+#include "conjure/completion-queue.h"
 #include "conjure/function-wrapper.h"
 #include "conjure/log.h"
+#include "conjure/select-state.h"
 #include "conjure/stack.h"
 #include "conjure/state.h"
 #include "conjure/system.h"
 #include "conjure/value-tunnel.h"
+#include "conjure/wait-list.h"
 #include <assert.h>
 #include <stdint.h>
+#include <atomic>
+#include <exception>
 #include <memory>
 #include <optional>
 #include <string>
@@ -17,7 +22,21 @@
 
 namespace conjure {
 
+namespace detail {
+
+// a Select waiting for a conjury to finish
+struct FinishWatcher {
+    SelectState *select;
+    int index;
+    FinishWatcher *prev = nullptr;
+    FinishWatcher *next = nullptr;
+};
+
+} // namespace detail
+
 class Conjury {
+    friend class CompletionQueue<Conjury>;
+
   public:
     using Pointer = std::unique_ptr<Conjury>;
 
@@ -27,28 +46,77 @@ class Conjury {
         // printf("coroutine stack: %p\n", context_.stack_ptr);
     }
 
-    virtual ~Conjury() = default;
+    // an exception nobody waited for would vanish with it otherwise
+    virtual ~Conjury() {
+        if (error_) {
+            ReportLostError();
+        }
+    }
 
     bool IsFinished() const {
         return state_ == State::kFinished;
     }
 
+    // Thread-safe. The first wake since the last ConsumeWakeUp hands the
+    // conjury to the completion queue of its scheduler.
     bool Wake() {
-        if (not wakeup_flag_) {
-            return wakeup_flag_ = true;
+        if (wakeup_flag_.exchange(true, std::memory_order_acq_rel)) {
+            return false;
         }
-        return false;
+        if (completion_queue_ != nullptr) {
+            completion_queue_->Push(this);
+        }
+        return true;
     }
 
     bool ConsumeWakeUp() {
-        if (wakeup_flag_) {
+        if (wakeup_flag_.exchange(false, std::memory_order_acq_rel)) {
             state_ = State::kReady;
-            wakeup_flag_ = false;
             return true;
         }
         return false;
     }
 
+    // drops a wake-up not consumed yet, returns false if there was none
+    bool ClearWakeUp() {
+        if (not wakeup_flag_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        return wakeup_flag_.exchange(false, std::memory_order_acq_rel);
+    }
+
+    void BindCompletionQueue(CompletionQueue<Conjury> *queue) {
+        completion_queue_ = queue;
+    }
+
+    void WatchFinish(detail::FinishWatcher *w) {
+        finish_watchers_.PushBack(w);
+    }
+
+    void UnwatchFinish(detail::FinishWatcher *w) {
+        if (finish_watchers_.Contains(w)) {
+            finish_watchers_.Remove(w);
+        }
+    }
+
+    // what its function threw, rethrown to whoever waits for or iterates it
+    void Fail(std::exception_ptr e) {
+        error_ = std::move(e);
+    }
+
+    std::exception_ptr TakeError() {
+        return std::move(error_);
+    }
+
+    // called once by the conjury itself on its way out
+    void NotifyFinish() {
+        for (; detail::FinishWatcher *w = finish_watchers_.PopFront();) {
+            if (w->select->TryClaim(w->index)) {
+                w->select->Waiter()->Wake();
+            }
+        }
+    }
+
     Conjury *ReturnTarget() {
         return return_target_;
     }
@@ -94,6 +162,16 @@ class Conjury {
     }
 
   protected:
+    void ReportLostError() const {
+        try {
+            std::rethrow_exception(error_);
+        } catch (const std::exception &e) {
+            CONJURE_LOGF("%s dropped with exception: %s", Name(), e.what());
+        } catch (...) {
+            CONJURE_LOGF("%s dropped with an exception", Name());
+        }
+    }
+
     Stack stack_;
     system::Context context_;
     State state_ = State::kInitial;
@@ -102,22 +180,62 @@ class Conjury {
     Conjury *return_target_ = nullptr;
     Conjury *wait_target_ = nullptr;
 
-    volatile bool wakeup_flag_ = false;
+    std::atomic<bool> wakeup_flag_ = false;
+    CompletionQueue<Conjury> *completion_queue_ = nullptr;
+    Conjury *completion_next_ = nullptr;
+
+    detail::WaitList<detail::FinishWatcher> finish_watchers_;
+    std::exception_ptr error_;
 
     std::string name_;
 };
 
 inline void End();
+inline Conjury *ActiveConjury();
 
+// An exception must not unwind past the coroutine stack, it's kept for the
+// conjury waiting for this one instead.
 template <typename F, typename... Args>
 void ConjuryCallWrapper(FunctionWrapper<F, Args...> *this_) {
-    this_->Call();
+    try {
+        this_->Call();
+    } catch (...) {
+        ActiveConjury()->Fail(std::current_exception());
+    }
     End();
 }
 
-template <typename Gen>
+// Result of a generator yielding Gs. With an `In` the consumer sends an In
+// for every value it asks for.
+template <typename Gen, typename In = void>
 struct Generating {};
 
+namespace detail {
+
+// the sending side of a two-way generator
+template <typename In>
+class Receiver {
+  public:
+    // the same value until ClearSent(), so it may be asked for repeatedly
+    const In *GetSentPtr() const {
+        return sent_.Peek();
+    }
+
+    // the sender's value is gone once the generator yielded
+    void ClearSent() {
+        sent_.Clear();
+    }
+
+    void StoreSent(const In &in) {
+        sent_.Pass(in);
+    }
+
+  private:
+    ValueTunnel<In> sent_;
+};
+
+} // namespace detail
+
 template <typename Result>
 class ConjuryClientImpl : public Conjury {
     struct ResultStore {
@@ -178,6 +296,71 @@ class ConjuryClient<Generating<G>> : public ConjuryClientImpl<Generating<G>> {
         return tunnel_.GetOne();
     }
 
+    // the current value, moved out when it was yielded as an rvalue
+    G TakeGen() {
+        return tunnel_.Take();
+    }
+
+    template <typename U>
+    void StoreGen(U &&u) {
+        tunnel_.Pass(std::forward<U>(u));
+    }
+
+    // takes over the value of the generator delegated to
+    void ForwardGen(ConjuryClient *from) {
+        tunnel_.Pass(from->tunnel_);
+    }
+
+    // the generator this one yields from, if any
+    ConjuryClient *Delegate() const {
+        return delegate_;
+    }
+
+    void Delegate(ConjuryClient *c) {
+        delegate_ = c;
+    }
+
+    ConjuryClient *Delegator() const {
+        return delegator_;
+    }
+
+    void Delegator(ConjuryClient *c) {
+        delegator_ = c;
+    }
+
+    // end of the delegation chain as last seen by the consumer, kept on the
+    // outermost generator so it isn't walked for every value
+    ConjuryClient *Innermost() {
+        return innermost_ != nullptr ? innermost_ : this;
+    }
+
+    void Innermost(ConjuryClient *c) {
+        innermost_ = c == this ? nullptr : c;
+    }
+
+  private:
+    ValueTunnel<G> tunnel_;
+    ConjuryClient *delegate_ = nullptr;
+    ConjuryClient *delegator_ = nullptr;
+    ConjuryClient *innermost_ = nullptr;
+};
+
+template <typename G, typename In>
+class ConjuryClient<Generating<G, In>>
+    : public ConjuryClientImpl<Generating<G, In>>,
+      public detail::Receiver<In> {
+  public:
+    using Pointer = std::unique_ptr<ConjuryClient>;
+    using ConjuryClientImpl<Generating<G, In>>::ConjuryClientImpl;
+
+    const G *GetGenPtr() {
+        return tunnel_.GetOne();
+    }
+
+    G TakeGen() {
+        return tunnel_.Take();
+    }
+
     template <typename U>
     void StoreGen(U &&u) {
         tunnel_.Pass(std::forward<U>(u));
@@ -0,0 +1,220 @@
+#ifndef CONJURE_FUTURE_H_
+#define CONJURE_FUTURE_H_
+
+#include "conjure/function-wrapper.h"
+#include "conjure/interfaces.h"
+#include <assert.h>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// One-shot results handed from any thread to a coroutine or a thread. The
+// promise and the future share one allocation; setting and awaiting a
+// result take an atomic exchange each and block only if the result isn't
+// there yet.
+//
+//     Promise<Reply> promise;
+//     Future<Reply> reply = promise.GetFuture();
+//     client.Call(request, [p = std::move(promise)](Reply r) mutable {
+//         p.SetValue(std::move(r));
+//     });
+//     Reply r = reply.Await();
+
+namespace conjure {
+
+class BrokenPromise : public std::logic_error {
+  public:
+    BrokenPromise() : std::logic_error("promise dropped without a result") {}
+};
+
+namespace detail {
+
+template <typename T>
+class FutureState {
+  public:
+    using ValueT = NormalizeVoidT<T>;
+
+    template <typename... U>
+    void SetValue(U &&... u) {
+        value_.emplace(std::forward<U>(u)...);
+        Publish();
+    }
+
+    void SetException(std::exception_ptr e) {
+        error_ = std::move(e);
+        Publish();
+    }
+
+    bool Ready() const {
+        return state_.load(std::memory_order_acquire) == kReady;
+    }
+
+    // Suspends the active conjury only, again if it was woken by anything
+    // but the result.
+    void Await() {
+        if (Ready()) {
+            return;
+        }
+        waiter_ = ActiveConjury();
+        for (; Park();) {
+            Suspend();
+        }
+    }
+
+    // blocks the calling thread, for threads not running coroutines
+    void Block() {
+        if (Ready()) {
+            return;
+        }
+        waiter_ = nullptr;
+        if (Park()) {
+            std::unique_lock<std::mutex> lock(mu_);
+            cv_.wait(lock, [this] { return Ready(); });
+        }
+    }
+
+    T Take() {
+        assert(Ready());
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+        if constexpr (not std::is_void_v<T>) {
+            return std::move(*value_);
+        }
+    }
+
+  private:
+    enum : int { kEmpty, kWaiting, kReady };
+
+    // false if the result came in meanwhile, true if parked already
+    bool Park() {
+        int expected = kEmpty;
+        if (state_.compare_exchange_strong(
+                expected, kWaiting, std::memory_order_acq_rel,
+                std::memory_order_acquire)) {
+            return true;
+        }
+        return expected == kWaiting;
+    }
+
+    void Publish() {
+        int prev = state_.exchange(kReady, std::memory_order_acq_rel);
+        assert(prev != kReady);
+        if (prev != kWaiting) {
+            return;
+        }
+        if (waiter_ != nullptr) {
+            waiter_->Wake();
+        } else {
+            std::lock_guard<std::mutex> lock(mu_);
+            cv_.notify_one();
+        }
+    }
+
+    std::atomic<int> state_ = kEmpty;
+    std::optional<ValueT> value_;
+    std::exception_ptr error_;
+
+    // set before parking, null for a blocked thread
+    Conjury *waiter_ = nullptr;
+    std::mutex mu_;
+    std::condition_variable cv_;
+};
+
+} // namespace detail
+
+template <typename T>
+class Future {
+  public:
+    Future() = default;
+
+    explicit Future(std::shared_ptr<detail::FutureState<T>> state)
+        : state_(std::move(state)) {}
+
+    bool Valid() const {
+        return state_ != nullptr;
+    }
+
+    bool Ready() const {
+        return state_->Ready();
+    }
+
+    // Suspends the active conjury until the result is set, then returns it
+    // or rethrows its exception. Once only.
+    T Await() {
+        state_->Await();
+        return Release()->Take();
+    }
+
+    // Await() for threads that don't run coroutines, blocks the thread
+    T Get() {
+        state_->Block();
+        return Release()->Take();
+    }
+
+  private:
+    std::shared_ptr<detail::FutureState<T>> Release() {
+        return std::move(state_);
+    }
+
+    std::shared_ptr<detail::FutureState<T>> state_;
+};
+
+// Any thread may set the result, once. Dropping a promise without setting
+// it hands its future a BrokenPromise.
+template <typename T>
+class Promise {
+  public:
+    Promise() : state_(std::make_shared<detail::FutureState<T>>()) {}
+
+    Promise(Promise &&) = default;
+
+    // breaks the promise assigned over unless it was set
+    Promise &operator=(Promise &&p) {
+        if (this != &p) {
+            Break();
+            state_ = std::move(p.state_);
+            set_ = p.set_;
+        }
+        return *this;
+    }
+
+    ~Promise() {
+        Break();
+    }
+
+    Future<T> GetFuture() {
+        return Future<T>(state_);
+    }
+
+    template <typename... U>
+    void SetValue(U &&... u) {
+        set_ = true;
+        state_->SetValue(std::forward<U>(u)...);
+    }
+
+    void SetException(std::exception_ptr e) {
+        set_ = true;
+        state_->SetException(std::move(e));
+    }
+
+  private:
+    void Break() {
+        if (state_ != nullptr and not set_) {
+            state_->SetException(std::make_exception_ptr(BrokenPromise()));
+        }
+    }
+
+    std::shared_ptr<detail::FutureState<T>> state_;
+    bool set_ = false;
+};
+
+} // namespace conjure
+
+#endif // CONJURE_FUTURE_H_
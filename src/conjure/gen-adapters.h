@@ -0,0 +1,459 @@
+#ifndef CONJURE_GEN_ADAPTERS_H_
+#define CONJURE_GEN_ADAPTERS_H_
+
+#include "conjure/gen-iterator.h"
+#include "conjure/interfaces.h"
+#include <assert.h>
+#include <stddef.h>
+#include <iterator>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Lazy adapters over generators, run inline by the consumer: only the source
+// is a coroutine, a pipeline of adapters costs no stacks and no switches of
+// its own.
+//
+//     for (auto [i, sq] : co | gen::Filter(odd) | gen::Map(square)
+//                            | gen::Take(5) | gen::Enumerate()) ...
+//
+// A view moves its source in, lvalue containers are referenced instead and
+// must outlive it. Views yield `const Value &`s valid until they're
+// advanced again. Views and generators mix with begin()/end() of
+// gen-iterator.h, both end at GenIterEnd.
+
+namespace conjure::gen {
+
+namespace detail {
+
+struct ViewTag {};
+
+struct ClosureTag {};
+
+template <typename View>
+struct ViewIterator {
+    using Self = ViewIterator;
+    using value_type = typename View::Value;
+    using reference = const value_type &;
+    using pointer = const value_type *;
+    using iterator_category = std::input_iterator_tag;
+
+    reference operator*() const {
+        return view->Current();
+    }
+
+    pointer operator->() const {
+        return &view->Current();
+    }
+
+    Self &operator++() {
+        valid = view->Advance();
+        return *this;
+    }
+
+    bool operator==(GenIterEnd) const {
+        return not valid;
+    }
+
+    bool operator!=(GenIterEnd) const {
+        return valid;
+    }
+
+    View *view;
+    bool valid;
+};
+
+// gives views begin() and end()
+template <typename View>
+struct ViewBase : ViewTag {
+    ViewIterator<View> begin() {
+        View *self = static_cast<View *>(this);
+        return {self, self->Advance()};
+    }
+
+    GenIterEnd end() const {
+        return {};
+    }
+};
+
+template <typename G>
+class SourceView : public ViewBase<SourceView<G>> {
+  public:
+    using Value = G;
+
+    explicit SourceView(ConjuryClient<Generating<G>> *co) : co_(co) {}
+
+    SourceView(SourceView &&v) : co_(std::exchange(v.co_, nullptr)) {}
+
+    SourceView(const SourceView &) = delete;
+
+    bool Advance() {
+        // the generator is gone once it finished
+        if (co_ == nullptr or not GenMoveNext(co_)) {
+            co_ = nullptr;
+            return false;
+        }
+        current_ = co_->GetGenPtr();
+        return true;
+    }
+
+    const G &Current() const {
+        return *current_;
+    }
+
+  private:
+    ConjuryClient<Generating<G>> *co_;
+    const G *current_ = nullptr;
+};
+
+// Refers to an lvalue container, C is a reference then, and owns an rvalue
+// one, so FlatMap may return plain vectors and the like.
+template <typename C>
+class ContainerView : public ViewBase<ContainerView<C>> {
+  public:
+    using Value = std::decay_t<decltype(*std::begin(std::declval<C &>()))>;
+
+    explicit ContainerView(C c) : c_(std::forward<C>(c)) {}
+
+    ContainerView(ContainerView &&v)
+        : c_(std::forward<C>(v.c_)), started_(false) {
+        // iterators of the moved-from container are useless
+        assert(not v.started_);
+    }
+
+    bool Advance() {
+        if (not started_) {
+            started_ = true;
+            it_ = std::begin(c_);
+        } else {
+            ++it_;
+        }
+        return it_ != std::end(c_);
+    }
+
+    const Value &Current() const {
+        return *it_;
+    }
+
+  private:
+    C c_;
+    bool started_ = false;
+    decltype(std::begin(std::declval<C &>())) it_;
+};
+
+template <typename G>
+SourceView<G> AsView(ConjuryClient<Generating<G>> *co) {
+    return SourceView<G>(co);
+}
+
+template <typename V, typename = std::enable_if_t<std::is_base_of_v<
+                          ViewTag, std::remove_reference_t<V>>>>
+std::remove_reference_t<V> AsView(V &&v) {
+    return std::move(v);
+}
+
+template <
+    typename C, typename = std::enable_if_t<
+                    not std::is_base_of_v<ViewTag, std::decay_t<C>> and
+                    not std::is_pointer_v<std::decay_t<C>>>,
+    typename = decltype(std::begin(std::declval<C &>()))>
+ContainerView<C> AsView(C &&c) {
+    return ContainerView<C>(std::forward<C>(c));
+}
+
+template <typename S>
+using ViewOf = decltype(AsView(std::declval<S>()));
+
+template <typename Src, typename F>
+class MapView : public ViewBase<MapView<Src, F>> {
+  public:
+    using Value = std::decay_t<
+        std::invoke_result_t<F &, const typename Src::Value &>>;
+
+    MapView(Src src, F f) : src_(std::move(src)), f_(std::move(f)) {}
+
+    bool Advance() {
+        if (not src_.Advance()) {
+            return false;
+        }
+        current_.emplace(f_(src_.Current()));
+        return true;
+    }
+
+    const Value &Current() const {
+        return *current_;
+    }
+
+  private:
+    Src src_;
+    F f_;
+    std::optional<Value> current_;
+};
+
+template <typename Src, typename P>
+class FilterView : public ViewBase<FilterView<Src, P>> {
+  public:
+    using Value = typename Src::Value;
+
+    FilterView(Src src, P p) : src_(std::move(src)), p_(std::move(p)) {}
+
+    bool Advance() {
+        for (; src_.Advance();) {
+            if (p_(src_.Current())) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const Value &Current() const {
+        return src_.Current();
+    }
+
+  private:
+    Src src_;
+    P p_;
+};
+
+// stops without resuming the source once `n` values were taken
+template <typename Src>
+class TakeView : public ViewBase<TakeView<Src>> {
+  public:
+    using Value = typename Src::Value;
+
+    TakeView(Src src, size_t n) : src_(std::move(src)), left_(n) {}
+
+    bool Advance() {
+        if (left_ == 0) {
+            return false;
+        }
+        --left_;
+        return src_.Advance();
+    }
+
+    const Value &Current() const {
+        return src_.Current();
+    }
+
+  private:
+    Src src_;
+    size_t left_;
+};
+
+// ends with the shorter of the two
+template <typename A, typename B>
+class ZipView : public ViewBase<ZipView<A, B>> {
+  public:
+    using Value =
+        std::pair<const typename A::Value &, const typename B::Value &>;
+
+    ZipView(A a, B b) : a_(std::move(a)), b_(std::move(b)) {}
+
+    bool Advance() {
+        if (not a_.Advance() or not b_.Advance()) {
+            return false;
+        }
+        current_.emplace(a_.Current(), b_.Current());
+        return true;
+    }
+
+    const Value &Current() const {
+        return *current_;
+    }
+
+  private:
+    A a_;
+    B b_;
+    std::optional<Value> current_;
+};
+
+// groups of `n` values, the last one may be shorter
+template <typename Src>
+class ChunkView : public ViewBase<ChunkView<Src>> {
+  public:
+    using Value = std::vector<typename Src::Value>;
+
+    ChunkView(Src src, size_t n) : src_(std::move(src)), n_(n) {
+        current_.reserve(n_);
+    }
+
+    bool Advance() {
+        current_.clear();
+        for (; current_.size() < n_ and src_.Advance();) {
+            current_.push_back(src_.Current());
+        }
+        return not current_.empty();
+    }
+
+    const Value &Current() const {
+        return current_;
+    }
+
+  private:
+    Src src_;
+    size_t n_;
+    Value current_;
+};
+
+template <typename Src>
+class EnumerateView : public ViewBase<EnumerateView<Src>> {
+  public:
+    using Value = std::pair<size_t, const typename Src::Value &>;
+
+    explicit EnumerateView(Src src) : src_(std::move(src)) {}
+
+    bool Advance() {
+        if (not src_.Advance()) {
+            return false;
+        }
+        current_.emplace(index_++, src_.Current());
+        return true;
+    }
+
+    const Value &Current() const {
+        return *current_;
+    }
+
+  private:
+    Src src_;
+    size_t index_ = 0;
+    std::optional<Value> current_;
+};
+
+// `f` returns a generator, a view or a container per value
+template <typename Src, typename F>
+class FlatMapView : public ViewBase<FlatMapView<Src, F>> {
+  public:
+    using Inner =
+        ViewOf<std::invoke_result_t<F &, const typename Src::Value &>>;
+    using Value = typename Inner::Value;
+
+    FlatMapView(Src src, F f) : src_(std::move(src)), f_(std::move(f)) {}
+
+    bool Advance() {
+        for (;;) {
+            if (inner_ and inner_->Advance()) {
+                return true;
+            }
+            if (not src_.Advance()) {
+                return false;
+            }
+            inner_.reset();
+            inner_.emplace(AsView(f_(src_.Current())));
+        }
+    }
+
+    const Value &Current() const {
+        return inner_->Current();
+    }
+
+  private:
+    Src src_;
+    F f_;
+    std::optional<Inner> inner_;
+};
+
+template <template <typename...> class View, typename... Params>
+struct Closure : ClosureTag {
+    template <typename S>
+    auto operator()(S &&s) && {
+        return std::apply(
+            [&s](auto &&... ps) {
+                return View<ViewOf<S>, std::decay_t<decltype(ps)>...>(
+                    AsView(std::forward<S>(s)), std::move(ps)...);
+            },
+            std::move(params));
+    }
+
+    std::tuple<Params...> params;
+};
+
+// views taking a size instead of a callable
+template <template <typename> class View>
+struct SizeClosure : ClosureTag {
+    template <typename S>
+    auto operator()(S &&s) && {
+        return View<ViewOf<S>>(AsView(std::forward<S>(s)), n);
+    }
+
+    size_t n;
+};
+
+template <template <typename> class View>
+struct NullaryClosure : ClosureTag {
+    template <typename S>
+    auto operator()(S &&s) && {
+        return View<ViewOf<S>>(AsView(std::forward<S>(s)));
+    }
+};
+
+template <typename B>
+struct ZipClosure : ClosureTag {
+    template <typename S>
+    auto operator()(S &&s) && {
+        return ZipView<ViewOf<S>, ViewOf<B>>(
+            AsView(std::forward<S>(s)), AsView(std::forward<B>(b)));
+    }
+
+    B b;
+};
+
+// found through the closure, so generators, views and containers all pipe
+template <
+    typename S, typename C,
+    typename = std::enable_if_t<
+        std::is_base_of_v<ClosureTag, std::decay_t<C>>>>
+auto operator|(S &&s, C &&c) {
+    return std::move(c)(std::forward<S>(s));
+}
+
+} // namespace detail
+
+template <typename F>
+auto Map(F f) {
+    return detail::Closure<detail::MapView, F>{{}, {std::move(f)}};
+}
+
+template <typename P>
+auto Filter(P p) {
+    return detail::Closure<detail::FilterView, P>{{}, {std::move(p)}};
+}
+
+template <typename F>
+auto FlatMap(F f) {
+    return detail::Closure<detail::FlatMapView, F>{{}, {std::move(f)}};
+}
+
+inline auto Take(size_t n) {
+    return detail::SizeClosure<detail::TakeView>{{}, n};
+}
+
+inline auto Chunk(size_t n) {
+    return detail::SizeClosure<detail::ChunkView>{{}, n};
+}
+
+inline auto Enumerate() {
+    return detail::NullaryClosure<detail::EnumerateView>{};
+}
+
+template <typename B>
+auto Zip(B &&b) {
+    return detail::ZipClosure<B>{{}, std::forward<B>(b)};
+}
+
+template <typename A, typename B>
+auto Zip(A &&a, B &&b) {
+    return Zip(std::forward<B>(b))(std::forward<A>(a));
+}
+
+// a generator, view or container as a view
+template <typename S>
+auto From(S &&s) {
+    return detail::AsView(std::forward<S>(s));
+}
+
+} // namespace conjure::gen
+
+#endif // CONJURE_GEN_ADAPTERS_H_
@@ -50,6 +50,58 @@ struct GenIterator {
     const G* current_ptr;
 };
 
+// Hands out generated values by value, moved out of the generator whenever
+// it yielded an rvalue. Each value is dereferenced at most once.
+template <typename G>
+struct GenMoveIterator {
+    using Self = GenMoveIterator;
+    using value_type = G;
+    using reference = G;
+    using pointer = void;
+    using iterator_category = std::input_iterator_tag;
+
+    G operator*() const {
+        return conjure->TakeGen();
+    }
+
+    Self &operator++() {
+        valid = GenMoveNext(conjure);
+        return *this;
+    }
+
+    bool operator==(GenIterEnd) const {
+        return not valid;
+    }
+
+    bool operator!=(GenIterEnd) const {
+        return valid;
+    }
+
+    ConjuryClient<Generating<G>> *conjure;
+    bool valid = false;
+};
+
+template <typename G>
+struct GenMoveRange {
+    GenMoveIterator<G> begin() const {
+        GenMoveIterator<G> iter{conjure};
+        ++iter;
+        return iter;
+    }
+
+    GenIterEnd end() const {
+        return {};
+    }
+
+    ConjuryClient<Generating<G>> *conjure;
+};
+
+// `for (G g : Moving(co))` keeps the values without copying rvalues
+template <typename G>
+GenMoveRange<G> Moving(ConjuryClient<Generating<G>> *co) {
+    return {co};
+}
+
 template <typename G>
 GenIterator<G> begin(ConjuryClient<Generating<G>> *co) {
     GenIterator<G> iter(co);
@@ -2,6 +2,7 @@
 #define CONJURE_INTERFACES_H_
 
 #include "conjure/conjurer.h"
+#include <optional>
 
 namespace conjure {
 
@@ -51,11 +52,30 @@ inline void Wait(Conjury* co) {
     Conjurer::Instance()->Wait(co);
 }
 
+// Parks the calling conjury until `deadline`, the scheduler keeps running
+// others meanwhile.
+inline void SleepUntil(TimerClock::time_point deadline) {
+    detail::Timer timer(deadline, ActiveConjury());
+    Conjurer::Instance()->AddTimer(&timer);
+    Suspend();
+}
+
+template <typename Rep, typename Period>
+void SleepFor(std::chrono::duration<Rep, Period> d) {
+    SleepUntil(TimerClock::now() + d);
+}
+
 template <typename G>
 bool GenMoveNext(ConjuryClient<Generating<G>> *co) {
     return Conjurer::Instance()->GenMoveNext(co);
 }
 
+template <typename G, typename In>
+bool GenMoveNext(
+    ConjuryClient<Generating<G, In>> *co, const std::common_type_t<In> &in) {
+    return Conjurer::Instance()->GenMoveNext(co, in);
+}
+
 template <typename G>
 const G *WaitGenerate(ConjuryClient<Generating<G>> *co) {
     if (not GenMoveNext(co)) {
@@ -64,9 +84,32 @@ const G *WaitGenerate(ConjuryClient<Generating<G>> *co) {
     return co->GetGenPtr();
 }
 
-template <typename U>
-void YieldWith(U &&u) {
-    return Conjurer::Instance()->YieldWith(std::forward<U>(u));
+// Resumes `co` for its next value and returns it, moved out when `co`
+// yielded an rvalue and copied otherwise. Empty once `co` finished.
+template <typename G>
+std::optional<G> TakeValue(ConjuryClient<Generating<G>> *co) {
+    if (not GenMoveNext(co)) {
+        return std::nullopt;
+    }
+    return co->TakeGen();
+}
+
+// `YieldWith<In>(out)` yields from a Generating<Out, In> and returns what
+// the consumer sends next
+template <typename In = void, typename U>
+decltype(auto) YieldWith(U &&u) {
+    return Conjurer::Instance()->YieldWith<In>(std::forward<U>(u));
+}
+
+// the value that started the active Generating<Out, In>, or resumed it
+template <typename In>
+const In &Received() {
+    return Conjurer::Instance()->Received<In>();
+}
+
+template <typename G>
+void YieldFrom(ConjuryClient<Generating<G>> *child) {
+    Conjurer::Instance()->YieldFrom(child);
 }
 
 } // namespace conjure
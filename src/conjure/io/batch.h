@@ -0,0 +1,103 @@
+#ifndef CONJURE_IO_BATCH_H_
+#define CONJURE_IO_BATCH_H_
+
+#include "conjure/io/job.h"
+#include "conjure/io/worker-pool.h"
+#include <algorithm>
+#include <vector>
+
+namespace conjure::io {
+
+// A group of jobs submitted together whose submitter suspends once for all,
+// any or the first n of them. Jobs must outlive the batch, the destructor
+// waits for the ones still in flight.
+class Batch {
+  public:
+    Batch() = default;
+
+    template <typename... Jobs>
+    explicit Batch(Jobs &... jobs) {
+        (Add(jobs), ...);
+    }
+
+    Batch(const Batch &) = delete;
+    Batch &operator=(const Batch &) = delete;
+
+    ~Batch() {
+        Await(submitted_);
+    }
+
+    template <typename JobImpl, typename R>
+    int Add(Job<JobImpl, R> &job) {
+        job.BindLatch(&latch_);
+        jobs_.push_back(&job);
+        pending_.push_back(&job);
+        return Size() - 1;
+    }
+
+    // hands every job added since the last submit to the worker pool
+    void Submit() {
+        if (pending_.empty()) {
+            return;
+        }
+        WorkerPool::Instance().Submit(pending_);
+        submitted_ += pending_.size();
+        pending_.clear();
+    }
+
+    // suspends until at least `n` of the submitted jobs are finished, returns
+    // the number of finished jobs
+    int Wait(int n) {
+        Submit();
+        return Await(std::min(n, submitted_));
+    }
+
+    int WaitAll() {
+        return Wait(submitted_ + (int)pending_.size());
+    }
+
+    // returns the index of a finished job, -1 for an empty batch
+    int WaitAny() {
+        Wait(1);
+        for (int i = 0; i < Size(); ++i) {
+            if (jobs_[i]->Finished()) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    bool Finished(int i) const {
+        return jobs_.at(i)->Finished();
+    }
+
+    int FinishedCount() const {
+        return latch_.Finished();
+    }
+
+    int Size() const {
+        return jobs_.size();
+    }
+
+  private:
+    int Await(int n) {
+        if (latch_.Arm(n)) {
+            Suspend();
+        }
+        for (JobBase *job : jobs_) {
+            if (job->Finished()) {
+                job->RecordLatency();
+            }
+        }
+        return latch_.Finished();
+    }
+
+    detail::Latch latch_;
+    std::vector<JobBase *> jobs_;
+    std::vector<JobBase *> pending_;
+    int submitted_ = 0;
+};
+
+} // namespace conjure::io
+
+#endif // CONJURE_IO_BATCH_H_
@@ -0,0 +1,242 @@
+#ifndef CONJURE_IO_BLOCK_CACHE_H_
+#define CONJURE_IO_BLOCK_CACHE_H_
+
+#include "conjure/io/interfaces.h"
+#include "conjure/io/sync-queue.h"
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace conjure::io {
+
+// A user space cache of file blocks in front of io::Pread. Blocks are keyed
+// by (fd, block index) and spread over shards, each evicting with CLOCK
+// under a fixed share of the memory cap. Concurrent misses on one block are
+// coalesced into a single read that every requester waits on.
+class BlockCache {
+  public:
+    struct Options {
+        size_t block_size = 4096;
+        size_t capacity = 64 << 20; // bytes
+        int shards = 16;
+    };
+
+    struct Stats {
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t coalesced;
+    };
+
+    BlockCache() : BlockCache(Options{}) {}
+
+    BlockCache(const Options &options)
+        : block_size_(options.block_size),
+          shards_(std::max(options.shards, 1)) {
+        size_t blocks = std::max(options.capacity / block_size_, (size_t)1);
+        size_t per_shard = std::max(blocks / shards_.size(), (size_t)1);
+        for (auto &shard : shards_) {
+            shard.blocks.resize(per_shard);
+        }
+    }
+
+    // pread() through the cache
+    ssize_t Read(int fd, void *dst, size_t n, off_t offset) {
+        char *out = (char *)dst;
+        size_t done = 0;
+        for (; done < n;) {
+            uint64_t index = (offset + done) / block_size_;
+            size_t skip = (offset + done) % block_size_;
+            ssize_t got = CopyBlock(
+                Key{fd, index}, out + done, skip,
+                std::min(n - done, block_size_ - skip));
+            if (got <= 0) {
+                return done == 0 ? got : (ssize_t)done;
+            }
+            done += got;
+            if (skip + got < block_size_) {
+                // short block, end of file
+                break;
+            }
+        }
+        return done;
+    }
+
+    // drops every block of `fd`, call it before the fd is closed or reused
+    void Invalidate(int fd) {
+        for (auto &shard : shards_) {
+            Lock::Guard hold(shard.lock);
+            for (auto &block : shard.blocks) {
+                if (block.key.fd == fd and block.state == Block::kValid) {
+                    shard.index.erase(block.key);
+                    block.state = Block::kEmpty;
+                }
+            }
+        }
+    }
+
+    Stats GetStats() const {
+        return {hits_.load(std::memory_order_relaxed),
+                misses_.load(std::memory_order_relaxed),
+                coalesced_.load(std::memory_order_relaxed)};
+    }
+
+    size_t BlockSize() const {
+        return block_size_;
+    }
+
+  private:
+    using Lock = detail::SpinLock;
+
+    struct Key {
+        int fd = -1;
+        uint64_t index = 0;
+
+        bool operator==(const Key &k) const {
+            return fd == k.fd and index == k.index;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key &k) const {
+            return std::hash<uint64_t>()(k.index * 31 + (uint64_t)k.fd);
+        }
+    };
+
+    struct Block {
+        enum State { kEmpty, kLoading, kValid };
+
+        Key key;
+        State state = kEmpty;
+        bool referenced = false;
+        ssize_t size = 0;
+        std::unique_ptr<char[]> data;
+        std::vector<Conjury *> waiters;
+    };
+
+    struct Shard {
+        Lock lock;
+        std::unordered_map<Key, int, KeyHash> index;
+        std::vector<Block> blocks;
+        size_t hand = 0;
+    };
+
+    // copies `n` bytes from `skip` within the block, returns the bytes copied
+    ssize_t CopyBlock(Key key, char *out, size_t skip, size_t n) {
+        Shard &shard = shards_[KeyHash()(key) % shards_.size()];
+        bool waited = false;
+        for (;;) {
+            shard.lock.lock();
+            auto iter = shard.index.find(key);
+            if (iter == shard.index.end()) {
+                return Load(shard, key, out, skip, n); // unlocks
+            }
+            Block &block = shard.blocks[iter->second];
+            if (block.state == Block::kLoading) {
+                if (not waited) {
+                    coalesced_.fetch_add(1, std::memory_order_relaxed);
+                    waited = true;
+                }
+                block.waiters.push_back(ActiveConjury());
+                shard.lock.unlock();
+                Suspend();
+                continue;
+            }
+            if (not waited) {
+                hits_.fetch_add(1, std::memory_order_relaxed);
+            }
+            block.referenced = true;
+            ssize_t copied = Copy(block, out, skip, n);
+            shard.lock.unlock();
+            return copied;
+        }
+    }
+
+    // called with the shard locked, returns with it unlocked
+    ssize_t Load(Shard &shard, Key key, char *out, size_t skip, size_t n) {
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        int victim = Evict(shard);
+        if (victim < 0) {
+            // every block is being loaded, read around the cache
+            shard.lock.unlock();
+            return io::Pread(key.fd, out, n, key.index * block_size_ + skip);
+        }
+        Block &block = shard.blocks[victim];
+        block.key = key;
+        block.state = Block::kLoading;
+        if (block.data == nullptr) {
+            block.data.reset(new char[block_size_]);
+        }
+        shard.index[key] = victim;
+        shard.lock.unlock();
+
+        ssize_t size = io::Pread(
+            key.fd, block.data.get(), block_size_, key.index * block_size_);
+
+        shard.lock.lock();
+        block.size = size;
+        std::vector<Conjury *> waiters = std::move(block.waiters);
+        block.waiters.clear();
+        ssize_t copied = size;
+        if (size < 0) {
+            // errors are not cached, waiters retry on their own
+            shard.index.erase(key);
+            block.state = Block::kEmpty;
+        } else {
+            block.state = Block::kValid;
+            block.referenced = true;
+            copied = Copy(block, out, skip, n);
+        }
+        shard.lock.unlock();
+        for (Conjury *c : waiters) {
+            c->Wake();
+        }
+        return copied;
+    }
+
+    static ssize_t Copy(const Block &block, char *out, size_t skip, size_t n) {
+        if (block.size <= (ssize_t)skip) {
+            return 0;
+        }
+        n = std::min(n, (size_t)block.size - skip);
+        memcpy(out, block.data.get() + skip, n);
+        return n;
+    }
+
+    // CLOCK sweep over the shard, -1 if every block is loading
+    static int Evict(Shard &shard) {
+        size_t total = shard.blocks.size();
+        for (size_t i = 0; i < 2 * total; ++i) {
+            size_t slot = shard.hand;
+            shard.hand = (shard.hand + 1) % total;
+            Block &block = shard.blocks[slot];
+            if (block.state == Block::kLoading) {
+                continue;
+            }
+            if (block.state == Block::kValid and block.referenced) {
+                block.referenced = false;
+                continue;
+            }
+            if (block.state == Block::kValid) {
+                shard.index.erase(block.key);
+            }
+            block.state = Block::kEmpty;
+            return slot;
+        }
+        return -1;
+    }
+
+    size_t block_size_;
+    std::vector<Shard> shards_;
+
+    std::atomic<uint64_t> hits_ = 0;
+    std::atomic<uint64_t> misses_ = 0;
+    std::atomic<uint64_t> coalesced_ = 0;
+};
+
+} // namespace conjure::io
+
+#endif // CONJURE_IO_BLOCK_CACHE_H_
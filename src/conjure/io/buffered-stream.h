@@ -0,0 +1,261 @@
+#ifndef CONJURE_IO_BUFFERED_STREAM_H_
+#define CONJURE_IO_BUFFERED_STREAM_H_
+
+#include "conjure/io/interfaces.h"
+#include <limits.h>
+#include <string.h>
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace conjure::io {
+
+namespace detail {
+
+constexpr size_t kMaxIoChunk = INT_MAX;
+
+} // namespace detail
+
+// Buffers reads from a file descriptor so that only refills go through the
+// worker pool. With read-ahead the free tail of the buffer is refilled in
+// the background while the buffered bytes are consumed.
+class BufferedReader {
+  public:
+    static constexpr size_t kDefaultCapacity = 64 * 1024;
+
+    BufferedReader(
+        int fd, size_t capacity = kDefaultCapacity, bool read_ahead = false)
+        : fd_(fd), capacity_(capacity), read_ahead_(read_ahead),
+          buffer_(new char[capacity]) {}
+
+    BufferedReader(const BufferedReader &) = delete;
+    BufferedReader &operator=(const BufferedReader &) = delete;
+
+    // reads up to and excluding `delim`, false if nothing is left
+    bool ReadLine(std::string &line, char delim = '\n') {
+        line.clear();
+        for (;;) {
+            const char *start = buffer_.get() + begin_;
+            const char *found = (const char *)memchr(start, delim, Buffered());
+            if (found != nullptr) {
+                line.append(start, found);
+                Consume(found - start + 1);
+                return true;
+            }
+            line.append(start, Buffered());
+            Consume(Buffered());
+            if (Fill() <= 0) {
+                return not line.empty();
+            }
+        }
+    }
+
+    // reads exactly `n` bytes unless the file ends first, returns the number
+    // of bytes read or -1 if nothing could be read because of an error
+    ssize_t ReadExact(void *dst, size_t n) {
+        char *out = (char *)dst;
+        size_t done = std::min(n, Buffered());
+        memcpy(out, buffer_.get() + begin_, done);
+        Consume(done);
+        for (; done < n;) {
+            ssize_t got;
+            if (n - done >= capacity_ and not pending_) {
+                // too large to be worth buffering
+                got = io::Read(
+                    fd_, out + done,
+                    (int)std::min(n - done, detail::kMaxIoChunk));
+            } else if ((got = Fill()) > 0) {
+                got = std::min((size_t)got, n - done);
+                memcpy(out + done, buffer_.get() + begin_, got);
+                Consume(got);
+            }
+            if (got <= 0) {
+                return done == 0 and got < 0 ? -1 : (ssize_t)done;
+            }
+            done += got;
+        }
+        return done;
+    }
+
+    // returns up to `n` buffered bytes without consuming them, fewer only at
+    // the end of file or when `n` exceeds the capacity
+    std::string_view Peek(size_t n) {
+        n = std::min(n, capacity_);
+        for (; Buffered() < n;) {
+            if (Fill() <= 0) {
+                break;
+            }
+        }
+        return {buffer_.get() + begin_, std::min(n, Buffered())};
+    }
+
+    void Skip(size_t n) {
+        Consume(std::min(n, Buffered()));
+    }
+
+    size_t Buffered() const {
+        return end_ - begin_;
+    }
+
+    int Fd() const {
+        return fd_;
+    }
+
+  private:
+    struct Refill {
+        Refill(int fd, char *buffer, size_t n)
+            : job(fd, buffer, (int)std::min(n, detail::kMaxIoChunk)),
+              batch(job) {
+            batch.Submit();
+        }
+
+        job::Read job;
+        Batch batch;
+    };
+
+    void Consume(size_t n) {
+        begin_ += n;
+        if (begin_ == end_ and not pending_) {
+            begin_ = end_ = 0;
+        }
+        if (read_ahead_ and not pending_ and not eof_ and
+            Buffered() < capacity_ / 2) {
+            StartRefill();
+        }
+    }
+
+    void StartRefill() {
+        if (begin_ > 0) {
+            memmove(buffer_.get(), buffer_.get() + begin_, Buffered());
+            end_ -= begin_;
+            begin_ = 0;
+        }
+        if (end_ < capacity_) {
+            pending_.emplace(fd_, buffer_.get() + end_, capacity_ - end_);
+        }
+    }
+
+    // appends at least one byte unless at the end of file or on error
+    ssize_t Fill() {
+        if (eof_) {
+            return 0;
+        }
+        if (not pending_) {
+            StartRefill();
+            if (not pending_) {
+                // a full buffer, nothing to refill
+                return 0;
+            }
+        }
+        pending_->batch.WaitAll();
+        ssize_t n = pending_->job.ReturnValue();
+        pending_.reset();
+        if (n > 0) {
+            end_ += n;
+        } else {
+            eof_ = n == 0;
+        }
+        return n;
+    }
+
+    int fd_;
+    size_t capacity_;
+    bool read_ahead_;
+    bool eof_ = false;
+
+    std::unique_ptr<char[]> buffer_;
+    size_t begin_ = 0;
+    size_t end_ = 0;
+
+    std::optional<Refill> pending_;
+};
+
+// Collects small writes and hands them to the worker pool in large chunks.
+class BufferedWriter {
+  public:
+    static constexpr size_t kDefaultCapacity = 64 * 1024;
+
+    enum class FlushPolicy {
+        kWhenFull, // only when the buffer can't take more
+        kLine,     // additionally after every write containing a newline
+    };
+
+    BufferedWriter(
+        int fd, size_t capacity = kDefaultCapacity,
+        FlushPolicy policy = FlushPolicy::kWhenFull)
+        : fd_(fd), capacity_(capacity), policy_(policy),
+          buffer_(new char[capacity]) {}
+
+    BufferedWriter(const BufferedWriter &) = delete;
+    BufferedWriter &operator=(const BufferedWriter &) = delete;
+
+    ~BufferedWriter() {
+        Flush();
+    }
+
+    // returns false if an earlier flush failed
+    bool Write(const void *data, size_t n) {
+        if (n > capacity_ - size_ and not Flush()) {
+            return false;
+        }
+        if (n >= capacity_) {
+            return WriteAll((const char *)data, n);
+        }
+        memcpy(buffer_.get() + size_, data, n);
+        size_ += n;
+        if (policy_ == FlushPolicy::kLine and memchr(data, '\n', n)) {
+            return Flush();
+        }
+        return true;
+    }
+
+    bool Write(std::string_view s) {
+        return Write(s.data(), s.size());
+    }
+
+    bool Flush() {
+        if (size_ == 0) {
+            return ok_;
+        }
+        WriteAll(buffer_.get(), size_);
+        size_ = 0;
+        return ok_;
+    }
+
+    size_t Buffered() const {
+        return size_;
+    }
+
+    int Fd() const {
+        return fd_;
+    }
+
+  private:
+    bool WriteAll(const char *data, size_t n) {
+        for (; n > 0 and ok_;) {
+            int written =
+                io::Write(fd_, data, (int)std::min(n, detail::kMaxIoChunk));
+            if (written <= 0) {
+                ok_ = false;
+                break;
+            }
+            data += written;
+            n -= written;
+        }
+        return ok_;
+    }
+
+    int fd_;
+    size_t capacity_;
+    FlushPolicy policy_;
+    bool ok_ = true;
+
+    std::unique_ptr<char[]> buffer_;
+    size_t size_ = 0;
+};
+
+} // namespace conjure::io
+
+#endif // CONJURE_IO_BUFFERED_STREAM_H_
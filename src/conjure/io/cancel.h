@@ -0,0 +1,65 @@
+#ifndef CONJURE_IO_CANCEL_H_
+#define CONJURE_IO_CANCEL_H_
+
+#include "conjure/io/job.h"
+#include "conjure/io/worker-pool.h"
+
+namespace conjure::io {
+
+// Cancels a submitted job without blocking. A queued job is dropped and its
+// waiter resumes right away; a running one has its syscall interrupted and
+// its waiter resumes once the worker let go of it. Must be called from the
+// scheduler thread of the waiter, which sees the job as failed with
+// ECANCELED.
+inline bool Cancel(JobBase &job) {
+    Worker *worker = job.AssignedWorker();
+    if (worker == nullptr or job.Finished()) {
+        return false;
+    }
+    return worker->Cancel(job);
+}
+
+// Handed to an io call by one coroutine and cancelled by another, e.g. a
+// deadline or a disconnect handler. Cancelling before the call was made makes
+// the call fail immediately.
+class CancelToken {
+  public:
+    CancelToken() = default;
+
+    CancelToken(const CancelToken &) = delete;
+    CancelToken &operator=(const CancelToken &) = delete;
+
+    bool Cancel() {
+        cancelled_ = true;
+        return job_ != nullptr and io::Cancel(*job_);
+    }
+
+    bool Cancelled() const {
+        return cancelled_;
+    }
+
+    void Reset() {
+        cancelled_ = false;
+    }
+
+    // false if the token is already cancelled
+    bool Bind(JobBase *job) {
+        if (cancelled_) {
+            return false;
+        }
+        job_ = job;
+        return true;
+    }
+
+    void Unbind() {
+        job_ = nullptr;
+    }
+
+  private:
+    JobBase *job_ = nullptr;
+    bool cancelled_ = false;
+};
+
+} // namespace conjure::io
+
+#endif // CONJURE_IO_CANCEL_H_
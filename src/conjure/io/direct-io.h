@@ -0,0 +1,292 @@
+#ifndef CONJURE_IO_DIRECT_IO_H_
+#define CONJURE_IO_DIRECT_IO_H_
+
+#include "conjure/io/interfaces.h"
+#include "conjure/wait-list.h"
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace conjure::io {
+
+constexpr size_t kDirectAlignment = 4096;
+
+namespace detail {
+
+inline bool IsAligned(uint64_t v, size_t alignment) {
+    return v % alignment == 0;
+}
+
+inline bool DirectArgsValid(const void *buffer, size_t n, off_t offset) {
+    return IsAligned((uint64_t)buffer, kDirectAlignment) and
+           IsAligned(n, kDirectAlignment) and
+           IsAligned((uint64_t)offset, kDirectAlignment);
+}
+
+} // namespace detail
+
+namespace job {
+
+// Positional reads and writes for descriptors opened with O_DIRECT. Misaligned
+// buffers, lengths or offsets fail with -1 and EINVAL without reaching the
+// kernel.
+struct DirectRead : Job<DirectRead, ssize_t> {
+    DirectRead(int fd, void *buffer, size_t nbyte, off_t offset)
+        : fd(fd), buffer(buffer), nbyte(nbyte), offset(offset) {}
+
+    static void Handle(DirectRead &r) {
+        if (not io::detail::DirectArgsValid(r.buffer, r.nbyte, r.offset)) {
+            errno = EINVAL;
+            r.readn = -1;
+            return;
+        }
+        r.readn = pread(r.fd, r.buffer, r.nbyte, r.offset);
+    }
+
+    ssize_t ReturnValue() {
+        return readn;
+    }
+
+    int fd;
+    void *buffer;
+    size_t nbyte;
+    off_t offset;
+
+    ssize_t readn = 0;
+};
+
+struct DirectWrite : Job<DirectWrite, ssize_t> {
+    DirectWrite(int fd, const void *buffer, size_t nbyte, off_t offset)
+        : fd(fd), buffer(buffer), nbyte(nbyte), offset(offset) {}
+
+    static void Handle(DirectWrite &w) {
+        if (not io::detail::DirectArgsValid(w.buffer, w.nbyte, w.offset)) {
+            errno = EINVAL;
+            w.writen = -1;
+            return;
+        }
+        w.writen = pwrite(w.fd, w.buffer, w.nbyte, w.offset);
+    }
+
+    ssize_t ReturnValue() {
+        return writen;
+    }
+
+    int fd;
+    const void *buffer;
+    size_t nbyte;
+    off_t offset;
+
+    ssize_t writen = 0;
+};
+
+} // namespace job
+
+// A fixed set of page aligned buffers carved out of one allocation, touched
+// up front so that no page faults happen in the middle of a transfer.
+// Coroutines acquiring from an exhausted pool park in arrival order and are
+// handed the returned buffers directly.
+class AlignedBufferPool {
+  public:
+    class Buffer {
+      public:
+        Buffer() = default;
+        Buffer(AlignedBufferPool *pool, char *data)
+            : pool_(pool), data_(data) {}
+
+        Buffer(Buffer &&b) : pool_(b.pool_), data_(b.data_) {
+            b.pool_ = nullptr;
+            b.data_ = nullptr;
+        }
+
+        Buffer &operator=(Buffer &&b) {
+            std::swap(pool_, b.pool_);
+            std::swap(data_, b.data_);
+            return *this;
+        }
+
+        ~Buffer() {
+            if (pool_ != nullptr) {
+                pool_->Release(data_);
+            }
+        }
+
+        char *Data() const {
+            return data_;
+        }
+
+        size_t Size() const {
+            return pool_ == nullptr ? 0 : pool_->BufferSize();
+        }
+
+      private:
+        AlignedBufferPool *pool_ = nullptr;
+        char *data_ = nullptr;
+    };
+
+    // `buffer_size` is rounded up to the alignment
+    AlignedBufferPool(size_t buffer_size, int count)
+        : buffer_size_(RoundUp(std::max(buffer_size, (size_t)1))) {
+        void *region = nullptr;
+        if (posix_memalign(&region, kDirectAlignment, buffer_size_ * count) !=
+            0) {
+            throw std::bad_alloc();
+        }
+        region_.reset((char *)region);
+        memset(region, 0, buffer_size_ * count);
+        for (int i = count - 1; i >= 0; --i) {
+            free_.push_back(region_.get() + i * buffer_size_);
+        }
+    }
+
+    Buffer Acquire() {
+        if (free_.empty()) {
+            Waiter w;
+            waiters_.PushBack(&w);
+            for (; w.data == nullptr;) {
+                Suspend();
+            }
+            return Buffer(this, w.data);
+        }
+        char *data = free_.back();
+        free_.pop_back();
+        return Buffer(this, data);
+    }
+
+    size_t BufferSize() const {
+        return buffer_size_;
+    }
+
+    int Available() const {
+        return free_.size();
+    }
+
+    static size_t RoundUp(size_t n) {
+        return (n + kDirectAlignment - 1) / kDirectAlignment * kDirectAlignment;
+    }
+
+  private:
+    struct Waiter {
+        Conjury *conjury = ActiveConjury();
+        char *data = nullptr;
+        Waiter *prev = nullptr;
+        Waiter *next = nullptr;
+    };
+
+    struct FreeDeleter {
+        void operator()(char *p) const {
+            free(p);
+        }
+    };
+
+    // hands the buffer to the first waiter, nobody can take it in between
+    void Release(char *data) {
+        if (Waiter *w = waiters_.PopFront()) {
+            w->data = data;
+            w->conjury->Wake();
+            return;
+        }
+        free_.push_back(data);
+    }
+
+    size_t buffer_size_;
+    std::unique_ptr<char, FreeDeleter> region_;
+    std::vector<char *> free_;
+    conjure::detail::WaitList<Waiter> waiters_;
+};
+
+// opens a file bypassing the page cache
+inline int OpenDirect(const char *p, int flag, int mode = 0) {
+#ifdef __linux__
+    return Open(p, flag | O_DIRECT, mode);
+#else
+    int fd = Open(p, flag, mode);
+    if (fd != -1) {
+        fcntl(fd, F_NOCACHE, 1);
+    }
+    return fd;
+#endif // __linux__
+}
+
+// Reads `n` bytes at `offset` in aligned chunks of at most `chunk` bytes
+// submitted as one batch. Returns the bytes read up to the first short or
+// failed chunk, -1 with the errno of the first chunk if that one failed and
+// -1 with EINVAL on misaligned arguments.
+inline ssize_t DirectRead(
+    int fd, void *buffer, size_t n, off_t offset, size_t chunk = 1 << 20) {
+    chunk = AlignedBufferPool::RoundUp(chunk);
+    if (not detail::DirectArgsValid(buffer, n, offset)) {
+        errno = EINVAL;
+        return -1;
+    }
+    std::vector<std::unique_ptr<job::DirectRead>> jobs;
+    Batch batch;
+    for (size_t done = 0; done < n; done += chunk) {
+        jobs.push_back(std::make_unique<job::DirectRead>(
+            fd, (char *)buffer + done, std::min(chunk, n - done),
+            offset + done));
+        batch.Add(*jobs.back());
+    }
+    batch.WaitAll();
+    ssize_t total = 0;
+    for (auto &j : jobs) {
+        ssize_t got = j->ReturnValue();
+        if (got < 0) {
+            if (total > 0) {
+                break;
+            }
+            errno = j->Error();
+            return -1;
+        }
+        total += got;
+        if ((size_t)got < j->nbyte) {
+            break;
+        }
+    }
+    return total;
+}
+
+inline ssize_t DirectWrite(
+    int fd, const void *buffer, size_t n, off_t offset,
+    size_t chunk = 1 << 20) {
+    chunk = AlignedBufferPool::RoundUp(chunk);
+    if (not detail::DirectArgsValid(buffer, n, offset)) {
+        errno = EINVAL;
+        return -1;
+    }
+    std::vector<std::unique_ptr<job::DirectWrite>> jobs;
+    Batch batch;
+    for (size_t done = 0; done < n; done += chunk) {
+        jobs.push_back(std::make_unique<job::DirectWrite>(
+            fd, (const char *)buffer + done, std::min(chunk, n - done),
+            offset + done));
+        batch.Add(*jobs.back());
+    }
+    batch.WaitAll();
+    ssize_t total = 0;
+    for (auto &j : jobs) {
+        ssize_t put = j->ReturnValue();
+        if (put < 0) {
+            if (total > 0) {
+                break;
+            }
+            errno = j->Error();
+            return -1;
+        }
+        total += put;
+        if ((size_t)put < j->nbyte) {
+            break;
+        }
+    }
+    return total;
+}
+
+} // namespace conjure::io
+
+#endif // CONJURE_IO_DIRECT_IO_H_
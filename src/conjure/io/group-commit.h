@@ -0,0 +1,86 @@
+#ifndef CONJURE_IO_GROUP_COMMIT_H_
+#define CONJURE_IO_GROUP_COMMIT_H_
+
+#include "conjure/io/interfaces.h"
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace conjure::io {
+
+// Lets coroutines of one scheduler share fdatasync calls. The first
+// committer of an fd leads: it yields `window` times so that others can
+// join its group, then syncs once for everyone. Commits arriving while a
+// sync is in flight are not covered by it and form the next group, whose
+// first member is handed the lead when the sync completes.
+class GroupCommit {
+  public:
+    GroupCommit(int window = 1) : window_(window) {}
+
+    // returns the fdatasync result shared by the whole group
+    int Commit(int fd) {
+        FdState &fs = fds_[fd];
+        if (fs.open == nullptr) {
+            fs.open = std::make_shared<Group>();
+        }
+        std::shared_ptr<Group> group = fs.open;
+        if (fs.syncing) {
+            group->members.push_back(ActiveConjury());
+            Suspend();
+            if (group->done) {
+                return group->result;
+            }
+            // handed the lead
+        }
+        return Lead(fd, fs, std::move(group));
+    }
+
+    int Syncs() const {
+        return syncs_;
+    }
+
+  private:
+    struct Group {
+        std::vector<Conjury *> members;
+        bool done = false;
+        int result = 0;
+    };
+
+    struct FdState {
+        std::shared_ptr<Group> open;
+        bool syncing = false;
+    };
+
+    int Lead(int fd, FdState &fs, std::shared_ptr<Group> group) {
+        fs.syncing = true;
+        for (int i = 0; i < window_; ++i) {
+            Yield();
+        }
+        // later commits can't be covered by this sync
+        fs.open = nullptr;
+        ++syncs_;
+        group->result = Fdatasync(fd);
+        group->done = true;
+        for (Conjury *c : group->members) {
+            c->Wake();
+        }
+
+        if (fs.open != nullptr and not fs.open->members.empty()) {
+            // hand the lead over, `syncing` stays set so no newcomer takes it
+            Conjury *next = fs.open->members.front();
+            fs.open->members.erase(fs.open->members.begin());
+            next->Wake();
+        } else {
+            fs.syncing = false;
+        }
+        return group->result;
+    }
+
+    int window_;
+    int syncs_ = 0;
+    std::unordered_map<int, FdState> fds_;
+};
+
+} // namespace conjure::io
+
+#endif // CONJURE_IO_GROUP_COMMIT_H_
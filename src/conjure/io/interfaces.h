@@ -1,22 +1,58 @@
 #ifndef CONJURE_IO_INTERFACES_H_
 #define CONJURE_IO_INTERFACES_H_
 
+#include "conjure/io/batch.h"
+#include "conjure/io/cancel.h"
 #include "conjure/io/operation.h"
 #include "conjure/io/worker-pool.h"
+#include <tuple>
 
 namespace conjure::io {
 
 namespace detail {
 
+// Failures come back as -1 with the worker's errno, cancellations as -1 with
+// ECANCELED.
 template <typename JobImpl, typename R>
-R SubmitAndSuspend(Job<JobImpl, R> &j) {
+R SubmitAndSuspend(Job<JobImpl, R> &j, CancelToken *token = nullptr) {
+    if (token != nullptr and not token->Bind(&j)) {
+        errno = ECANCELED;
+        return -1;
+    }
     WorkerPool::Instance().Submit(j);
     Suspend();
-    return j.ReturnValue();
+    j.RecordLatency();
+    if (token != nullptr) {
+        token->Unbind();
+    }
+    if (j.Cancelled()) {
+        errno = ECANCELED;
+        return -1;
+    }
+    R result = j.ReturnValue();
+    if (result < 0) {
+        errno = j.Error();
+    }
+    return result;
 }
 
 } // namespace detail
 
+// Submits all jobs at once, suspends once until every one of them finished and
+// returns their results in order.
+template <typename... Jobs>
+std::tuple<typename Jobs::ResultT...> WhenAll(Jobs &... jobs) {
+    Batch batch(jobs...);
+    batch.WaitAll();
+    return {jobs.ReturnValue()...};
+}
+
+// Runs any job so that `token` can cancel it from another coroutine.
+template <typename JobImpl, typename R>
+R Run(Job<JobImpl, R> &j, CancelToken &token) {
+    return detail::SubmitAndSuspend(j, &token);
+}
+
 inline int Open(const char *p, int flag, int mode = 0) {
     constexpr int kDefaultMode =
         S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH;
@@ -46,11 +82,110 @@ inline int Write(int fd, const void *buffer, int nbyte) {
     return detail::SubmitAndSuspend(j);
 }
 
+inline int Read(int fd, void *buffer, int nbyte, CancelToken &token) {
+    job::Read j(fd, buffer, nbyte);
+    return detail::SubmitAndSuspend(j, &token);
+}
+
+inline int
+Write(int fd, const void *buffer, int nbyte, CancelToken &token) {
+    job::Write j(fd, buffer, nbyte);
+    return detail::SubmitAndSuspend(j, &token);
+}
+
 template <size_t N>
 int Write(int fd, const char (&arr)[N]) {
     return Write(fd, arr, N - 1);
 }
 
+inline ssize_t Pread(int fd, void *buffer, size_t nbyte, off_t offset) {
+    job::Pread j(fd, buffer, nbyte, offset);
+    return detail::SubmitAndSuspend(j);
+}
+
+inline ssize_t
+Pwrite(int fd, const void *buffer, size_t nbyte, off_t offset) {
+    job::Pwrite j(fd, buffer, nbyte, offset);
+    return detail::SubmitAndSuspend(j);
+}
+
+inline ssize_t Readv(int fd, const struct iovec *iov, int iovcnt) {
+    job::Readv j(fd, iov, iovcnt);
+    return detail::SubmitAndSuspend(j);
+}
+
+inline ssize_t Writev(int fd, const struct iovec *iov, int iovcnt) {
+    job::Writev j(fd, iov, iovcnt);
+    return detail::SubmitAndSuspend(j);
+}
+
+inline ssize_t
+Preadv(int fd, const struct iovec *iov, int iovcnt, off_t offset) {
+    job::Preadv j(fd, iov, iovcnt, offset);
+    return detail::SubmitAndSuspend(j);
+}
+
+inline ssize_t
+Pwritev(int fd, const struct iovec *iov, int iovcnt, off_t offset) {
+    job::Pwritev j(fd, iov, iovcnt, offset);
+    return detail::SubmitAndSuspend(j);
+}
+
+inline int Fsync(int fd) {
+    job::Fsync j(fd);
+    return detail::SubmitAndSuspend(j);
+}
+
+inline int Fdatasync(int fd) {
+    job::Fdatasync j(fd);
+    return detail::SubmitAndSuspend(j);
+}
+
+inline int Close(int fd) {
+    job::Close j(fd);
+    return detail::SubmitAndSuspend(j);
+}
+
+#ifdef __linux__
+
+inline ssize_t Preadv2(
+    int fd, const struct iovec *iov, int iovcnt, off_t offset, int flags) {
+    job::Preadv2 j(fd, iov, iovcnt, offset, flags);
+    return detail::SubmitAndSuspend(j);
+}
+
+inline ssize_t Sendfile(int out_fd, int in_fd, off_t *offset, size_t count) {
+    job::Sendfile j(out_fd, in_fd, offset, count);
+    return detail::SubmitAndSuspend(j);
+}
+
+inline ssize_t Splice(
+    int fd_in, loff_t *off_in, int fd_out, loff_t *off_out, size_t len,
+    unsigned int flags = 0) {
+    job::Splice j(fd_in, off_in, fd_out, off_out, len, flags);
+    return detail::SubmitAndSuspend(j);
+}
+
+inline ssize_t Tee(int fd_in, int fd_out, size_t len, unsigned int flags = 0) {
+    job::Tee j(fd_in, fd_out, len, flags);
+    return detail::SubmitAndSuspend(j);
+}
+
+inline ssize_t CopyFileRange(
+    int fd_in, loff_t *off_in, int fd_out, loff_t *off_out, size_t len,
+    unsigned int flags = 0) {
+    job::CopyFileRange j(fd_in, off_in, fd_out, off_out, len, flags);
+    return detail::SubmitAndSuspend(j);
+}
+
+inline int
+SyncFileRange(int fd, off_t offset, off_t nbytes, unsigned int flags) {
+    job::SyncFileRange j(fd, offset, nbytes, flags);
+    return detail::SubmitAndSuspend(j);
+}
+
+#endif // __linux__
+
 } // namespace conjure::io
 
 #endif // CONJURE_IO_INTERFACES_H_
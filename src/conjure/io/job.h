@@ -2,6 +2,11 @@
 #define CONJURE_IO_JOB_H_
 
 #include "conjure/interfaces.h"
+#include "conjure/io/latency.h"
+#include <errno.h>
+#include <stdint.h>
+#include <atomic>
+#include <thread>
 #include <type_traits>
 
 namespace conjure::io {
@@ -23,36 +28,301 @@ struct PrimJob {
                        }};
     }
 
+    static PrimJob Noop() {
+        return PrimJob{nullptr, nullptr, [](void *, void *) {}};
+    }
+
     void *func;
     void *param;
     Converter converter;
 };
 
-template <typename JobImpl, typename T>
-struct Job {
-    Job() : blocking_conjury_(ActiveConjury()) {}
+class Worker;
 
-    PrimJob ToPrimitive() {
-        return PrimJob::Make(Job::HandleAndSetReady, *this);
+namespace detail {
+
+// Counts finished jobs of a batch. Lower half of the state is the number of
+// finished jobs, upper half the number a waiter is currently suspended for.
+class Latch {
+  public:
+    int Finished() const {
+        return Count(state_.load(std::memory_order_acquire));
     }
 
-    T ReturnValue() {
-        return static_cast<JobImpl &>(*this).ReturnValue();
+    // returns false if `n` jobs are already finished, otherwise the caller
+    // must suspend and will be woken exactly once
+    bool Arm(int n) {
+        waiter_ = ActiveConjury();
+        uint64_t s = state_.load(std::memory_order_acquire);
+        do {
+            if (Count(s) >= n) {
+                return false;
+            }
+        } while (not state_.compare_exchange_weak(
+            s, Pack(n, Count(s)), std::memory_order_acq_rel,
+            std::memory_order_acquire));
+        return true;
+    }
+
+    // the latch may be gone once this returns unless it woke the waiter
+    void CountDown() {
+        uint64_t s = state_.fetch_add(1, std::memory_order_acq_rel);
+        int target = Target(s);
+        if (target != 0 and Count(s) + 1 == target) {
+            waiter_->Wake();
+        }
+    }
+
+  private:
+    static int Count(uint64_t s) {
+        return (int)(s & 0xffffffff);
+    }
+    static int Target(uint64_t s) {
+        return (int)(s >> 32);
+    }
+    static uint64_t Pack(int target, int count) {
+        return ((uint64_t)target << 32) | (uint32_t)count;
+    }
+
+    std::atomic<uint64_t> state_ = 0;
+    Conjury *waiter_ = nullptr;
+};
+
+// Lets a Select be notified of the job's completion in place of its submitter
+struct CompletionHook {
+    conjure::detail::SelectState *select;
+    int index;
+};
+
+} // namespace detail
+
+struct JobBase {
+    friend class Worker;
+
+    // queued -> running -> done
+    //      \         \-> interrupting -> interrupted  (signalled while running)
+    //       \-> cancelled                         (removed or never started)
+    // A canceller sending a signal holds the job in kSignalling meanwhile.
+    enum Phase {
+        kQueued,
+        kRunning,
+        kInterrupting,
+        kSignalling,
+        kInterrupted,
+        kDone,
+        kCancelled
+    };
+
+    JobBase() : blocking_conjury_(ActiveConjury()) {}
+
+    JobBase(const JobBase &) = delete;
+    JobBase &operator=(const JobBase &) = delete;
+
+    PrimJob ToPrimitive() const {
+        return prim_;
+    }
+
+    bool Finished() const {
+        return finished_.load(std::memory_order_acquire);
+    }
+
+    // true if the job was dropped before running or its syscall was
+    // interrupted by a cancellation
+    bool Cancelled() const {
+        int p = phase_.load(std::memory_order_acquire);
+        return p == kCancelled or (p == kInterrupted and error_ == EINTR);
+    }
+
+    // errno of the handler, valid once finished
+    int Error() const {
+        return error_;
+    }
+
+    Worker *AssignedWorker() const {
+        return worker_;
     }
 
     void BindConjury(Conjury *c) {
         blocking_conjury_ = c;
     }
 
+    void BindLatch(detail::Latch *latch) {
+        latch_ = latch;
+    }
+
+    // Notifies `hook` instead of the submitter on completion. Returns false if
+    // the job has already completed.
+    bool Hook(detail::CompletionHook *hook) {
+        detail::CompletionHook *h = hook_.load(std::memory_order_acquire);
+        do {
+            if (h == Completed()) {
+                AwaitFinished();
+                return false;
+            }
+        } while (not hook_.compare_exchange_weak(
+            h, hook, std::memory_order_acq_rel, std::memory_order_acquire));
+        return true;
+    }
+
+    // Detaches the hook, the job then notifies nobody when it completes.
+    // Returns false if the hook was already notified.
+    bool Unhook() {
+        return Hook(Detached());
+    }
+
+    // Called by the submitter once it runs again after the job finished.
+    // Records the stages of a tracked job, at most once.
+    void RecordLatency() {
+        if (latency_ == nullptr or stamps_[kDequeued] == 0) {
+            return;
+        }
+        uint64_t now = detail::NowNs();
+        OpLatency &op = *latency_;
+        op[LatencyStage::kQueue].Record(
+            stamps_[kDequeued] - stamps_[kSubmitted]);
+        op[LatencyStage::kSyscall].Record(
+            stamps_[kHandled] - stamps_[kDequeued]);
+        op[LatencyStage::kResume].Record(now - stamps_[kHandled]);
+        op[LatencyStage::kTotal].Record(now - stamps_[kSubmitted]);
+        latency_ = nullptr;
+    }
+
+  protected:
+    enum Stamp { kSubmitted, kDequeued, kHandled, kStampCount };
+
+    void SetPrimitive(PrimJob prim) {
+        prim_ = prim;
+    }
+
+    void TrackLatency(OpLatency *op) {
+        latency_ = op;
+    }
+
+    void StampNow(Stamp s) {
+        if (latency_ != nullptr) {
+            stamps_[s] = detail::NowNs();
+        }
+    }
+
+    bool Start() {
+        int p = kQueued;
+        return phase_.compare_exchange_strong(
+            p, kRunning, std::memory_order_acq_rel);
+    }
+
+    // returns false if a cancellation signal was aimed at this job
+    bool Finish(int error) {
+        error_ = error;
+        int p = kRunning;
+        return phase_.compare_exchange_strong(
+            p, kDone, std::memory_order_acq_rel);
+    }
+
+    // a cancellation aimed at the job came in, the worker may skip it
+    bool Interrupted() const {
+        return phase_.load(std::memory_order_acquire) != kRunning;
+    }
+
+    // Acknowledges a cancellation once the syscall returned, the worker then
+    // stops the signals being sent again. Those sent are pending on this
+    // thread and get handled on the way back from the next syscall, so none
+    // can interrupt whatever the worker runs next.
+    void AwaitInterruption() {
+        for (int p = kInterrupting; not phase_.compare_exchange_weak(
+                 p, kInterrupted, std::memory_order_acq_rel);
+             p = kInterrupting) {
+            std::this_thread::yield();
+        }
+        std::this_thread::yield();
+    }
+
+    // called by the worker after handling, the last access to the job
+    void Complete() {
+        Conjury *c = blocking_conjury_;
+        detail::Latch *latch = latch_;
+        detail::CompletionHook *h =
+            hook_.exchange(Completed(), std::memory_order_acq_rel);
+        if (h != nullptr) {
+            if (h != Detached() and h->select->TryClaim(h->index)) {
+                h->select->Waiter()->Wake();
+            }
+            // the hooker waits for this before dropping the hook
+            finished_.store(true, std::memory_order_release);
+            return;
+        }
+        finished_.store(true, std::memory_order_release);
+        if (latch != nullptr) {
+            latch->CountDown();
+        } else {
+            assert(c != nullptr);
+            c->Wake();
+        }
+    }
+
+    std::atomic<int> phase_ = kQueued;
+
   private:
-    static void HandleAndSetReady(Job &j) {
-        JobImpl &ji = static_cast<JobImpl &>(j);
-        JobImpl::Handle(ji);
-        assert(j.blocking_conjury_ != nullptr);
-        j.blocking_conjury_->Wake();
+    static detail::CompletionHook *Detached() {
+        static detail::CompletionHook detached;
+        return &detached;
+    }
+
+    static detail::CompletionHook *Completed() {
+        static detail::CompletionHook completed;
+        return &completed;
+    }
+
+    void AwaitFinished() {
+        for (; not Finished();) {
+            std::this_thread::yield();
+        }
     }
 
+    PrimJob prim_;
     Conjury *blocking_conjury_;
+    detail::Latch *latch_ = nullptr;
+    Worker *worker_ = nullptr;
+    std::atomic<bool> finished_ = false;
+    std::atomic<detail::CompletionHook *> hook_ = nullptr;
+    int error_ = 0;
+    OpLatency *latency_ = nullptr;
+    uint64_t stamps_[kStampCount] = {};
+};
+
+template <typename JobImpl, typename T>
+struct Job : JobBase {
+    using ResultT = T;
+
+    Job() {
+        SetPrimitive(PrimJob::Make(Job::HandleAndSetReady, *this));
+        if (LatencyTrackingEnabled()) {
+            TrackLatency(&detail::OpLatencyOf<JobImpl>());
+        }
+    }
+
+    T ReturnValue() {
+        return static_cast<JobImpl &>(*this).ReturnValue();
+    }
+
+  private:
+    static void HandleAndSetReady(Job &j) {
+        if (j.Start()) {
+            j.StampNow(kDequeued);
+            JobImpl &ji = static_cast<JobImpl &>(j);
+            errno = 0;
+            // a signal landing before the syscall is lost, look first
+            if (j.Interrupted()) {
+                errno = EINTR;
+            } else {
+                JobImpl::Handle(ji);
+            }
+            j.StampNow(kHandled);
+            if (not j.Finish(errno)) {
+                j.AwaitInterruption();
+            }
+        }
+        j.Complete();
+    }
 };
 
 } // namespace conjure::io
@@ -0,0 +1,241 @@
+#ifndef CONJURE_IO_LATENCY_H_
+#define CONJURE_IO_LATENCY_H_
+
+#include <cxxabi.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+namespace conjure::io {
+
+// submit -> dequeue -> syscall done -> resume
+//   queue     syscall        resume
+//   <------------ total ------------>
+enum class LatencyStage { kQueue, kSyscall, kResume, kTotal };
+
+constexpr int kLatencyStageCount = 4;
+
+// Log-linear buckets in the manner of HdrHistogram: every power of two range
+// is split into kSubCount linear buckets, so a recorded value is off by at
+// most 1/kSubCount. Recording is a relaxed fetch_add, safe from any thread.
+class LatencyHistogram {
+  public:
+    static constexpr int kSubBits = 5;
+    static constexpr int kSubCount = 1 << kSubBits;
+    static constexpr int kBucketCount = (64 - kSubBits + 1) * kSubCount;
+
+    void Record(uint64_t value) {
+        buckets_[BucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        uint64_t max = max_.load(std::memory_order_relaxed);
+        for (; value > max and
+               not max_.compare_exchange_weak(
+                   max, value, std::memory_order_relaxed);) {
+        }
+    }
+
+    uint64_t Count() const {
+        return count_.load(std::memory_order_relaxed);
+    }
+
+    uint64_t Max() const {
+        return max_.load(std::memory_order_relaxed);
+    }
+
+    // Upper bound of the bucket holding the `q` quantile, 0 < q <= 1. Reads
+    // the buckets in place, concurrent records may or may not be counted.
+    uint64_t Percentile(double q) const {
+        uint64_t total = 0;
+        for (const auto &b : buckets_) {
+            total += b.load(std::memory_order_relaxed);
+        }
+        if (total == 0) {
+            return 0;
+        }
+        uint64_t rank = std::max((uint64_t)(q * total + 0.5), (uint64_t)1);
+        uint64_t seen = 0;
+        for (int i = 0; i < kBucketCount; ++i) {
+            seen += buckets_[i].load(std::memory_order_relaxed);
+            if (seen >= rank) {
+                return std::min(UpperOf(i), Max());
+            }
+        }
+        return Max();
+    }
+
+    void Reset() {
+        for (auto &b : buckets_) {
+            b.store(0, std::memory_order_relaxed);
+        }
+        count_.store(0, std::memory_order_relaxed);
+        max_.store(0, std::memory_order_relaxed);
+    }
+
+  private:
+    static int BucketOf(uint64_t v) {
+        if (v < kSubCount) {
+            return v;
+        }
+        int shift = 63 - __builtin_clzll(v) - kSubBits;
+        return (shift + 1) * kSubCount + (int)((v >> shift) - kSubCount);
+    }
+
+    static uint64_t UpperOf(int bucket) {
+        if (bucket < kSubCount) {
+            return bucket;
+        }
+        int shift = bucket / kSubCount - 1;
+        uint64_t sub = bucket % kSubCount + kSubCount;
+        return ((sub + 1) << shift) - 1;
+    }
+
+    std::atomic<uint64_t> buckets_[kBucketCount] = {};
+    std::atomic<uint64_t> count_ = 0;
+    std::atomic<uint64_t> max_ = 0;
+};
+
+// histograms of one job type, in nanoseconds
+struct OpLatency {
+    explicit OpLatency(const std::string &op) : op(op) {}
+
+    LatencyHistogram &operator[](LatencyStage s) {
+        return stages[(int)s];
+    }
+
+    std::string op;
+    LatencyHistogram stages[kLatencyStageCount];
+};
+
+struct StageSnapshot {
+    uint64_t count = 0;
+    uint64_t p50 = 0;
+    uint64_t p90 = 0;
+    uint64_t p99 = 0;
+    uint64_t p999 = 0;
+    uint64_t max = 0;
+};
+
+struct OpLatencySnapshot {
+    const StageSnapshot &operator[](LatencyStage s) const {
+        return stages[(int)s];
+    }
+
+    std::string op;
+    StageSnapshot stages[kLatencyStageCount];
+};
+
+namespace detail {
+
+inline std::atomic<bool> latency_tracking = false;
+
+inline uint64_t NowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+class LatencyRegistry {
+  public:
+    static LatencyRegistry &Instance() {
+        static LatencyRegistry registry;
+        return registry;
+    }
+
+    // Jobs of the same name share one entry, e.g. every OffloadJob
+    // instantiation.
+    OpLatency &Register(const std::string &op) {
+        std::lock_guard<std::mutex> hold(lock_);
+        for (OpLatency &existing : ops_) {
+            if (existing.op == op) {
+                return existing;
+            }
+        }
+        return ops_.emplace_back(op);
+    }
+
+    std::vector<OpLatencySnapshot> Snapshot() {
+        std::lock_guard<std::mutex> hold(lock_);
+        std::vector<OpLatencySnapshot> snapshot;
+        for (OpLatency &op : ops_) {
+            if (op[LatencyStage::kTotal].Count() == 0) {
+                continue;
+            }
+            OpLatencySnapshot &s = snapshot.emplace_back();
+            s.op = op.op;
+            for (int i = 0; i < kLatencyStageCount; ++i) {
+                const LatencyHistogram &h = op.stages[i];
+                s.stages[i] = {h.Count(),          h.Percentile(0.5),
+                               h.Percentile(0.9),  h.Percentile(0.99),
+                               h.Percentile(0.999), h.Max()};
+            }
+        }
+        return snapshot;
+    }
+
+    void Reset() {
+        std::lock_guard<std::mutex> hold(lock_);
+        for (OpLatency &op : ops_) {
+            for (auto &h : op.stages) {
+                h.Reset();
+            }
+        }
+    }
+
+  private:
+    std::mutex lock_;
+    // stable addresses, jobs keep pointers into it
+    std::deque<OpLatency> ops_;
+};
+
+// unqualified type name without template arguments, e.g. "Pread"
+template <typename T>
+std::string OpName() {
+    int status = 0;
+    char *demangled =
+        abi::__cxa_demangle(typeid(T).name(), nullptr, nullptr, &status);
+    std::string name = status == 0 ? demangled : typeid(T).name();
+    free(demangled);
+    name = name.substr(0, name.find('<'));
+    size_t colon = name.rfind("::");
+    return colon == std::string::npos ? name : name.substr(colon + 2);
+}
+
+template <typename JobImpl>
+OpLatency &OpLatencyOf() {
+    static OpLatency &op =
+        LatencyRegistry::Instance().Register(OpName<JobImpl>());
+    return op;
+}
+
+} // namespace detail
+
+// Off by default. Jobs created while enabled get their stages timestamped,
+// which costs four clock reads per job.
+inline void EnableLatencyTracking(bool enabled = true) {
+    detail::latency_tracking.store(enabled, std::memory_order_relaxed);
+}
+
+inline bool LatencyTrackingEnabled() {
+    return detail::latency_tracking.load(std::memory_order_relaxed);
+}
+
+// percentiles per job type and stage, job types nothing was recorded for are
+// left out
+inline std::vector<OpLatencySnapshot> LatencySnapshot() {
+    return detail::LatencyRegistry::Instance().Snapshot();
+}
+
+inline void ResetLatency() {
+    detail::LatencyRegistry::Instance().Reset();
+}
+
+} // namespace conjure::io
+
+#endif // CONJURE_IO_LATENCY_H_
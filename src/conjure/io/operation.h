@@ -2,10 +2,17 @@
 #define CONJURE_IO_OPERATION_H_
 
 #include "conjure/io/job.h"
+#include <errno.h>
 #include <fcntl.h>
+#include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #include <string>
 
+#ifdef __linux__
+#include <sys/sendfile.h>
+#endif // __linux__
+
 namespace conjure::io::job {
 
 struct Open : Job<Open, int> {
@@ -64,6 +71,350 @@ struct Write : Job<Write, int> {
     int writen = 0;
 };
 
+struct Pread : Job<Pread, ssize_t> {
+    Pread(int fd, void *buffer, size_t nbyte, off_t offset)
+        : fd(fd), buffer(buffer), nbyte(nbyte), offset(offset) {}
+
+    static void Handle(Pread &r) {
+        r.readn = pread(r.fd, r.buffer, r.nbyte, r.offset);
+    }
+
+    ssize_t ReturnValue() {
+        return readn;
+    }
+
+    int fd;
+    void *buffer;
+    size_t nbyte;
+    off_t offset;
+
+    ssize_t readn = 0;
+};
+
+struct Pwrite : Job<Pwrite, ssize_t> {
+    Pwrite(int fd, const void *buffer, size_t nbyte, off_t offset)
+        : fd(fd), buffer(buffer), nbyte(nbyte), offset(offset) {}
+
+    static void Handle(Pwrite &w) {
+        w.writen = pwrite(w.fd, w.buffer, w.nbyte, w.offset);
+    }
+
+    ssize_t ReturnValue() {
+        return writen;
+    }
+
+    int fd;
+    const void *buffer;
+    size_t nbyte;
+    off_t offset;
+
+    ssize_t writen = 0;
+};
+
+struct Readv : Job<Readv, ssize_t> {
+    Readv(int fd, const struct iovec *iov, int iovcnt)
+        : fd(fd), iov(iov), iovcnt(iovcnt) {}
+
+    static void Handle(Readv &r) {
+        r.readn = readv(r.fd, r.iov, r.iovcnt);
+    }
+
+    ssize_t ReturnValue() {
+        return readn;
+    }
+
+    int fd;
+    const struct iovec *iov;
+    int iovcnt;
+
+    ssize_t readn = 0;
+};
+
+struct Writev : Job<Writev, ssize_t> {
+    Writev(int fd, const struct iovec *iov, int iovcnt)
+        : fd(fd), iov(iov), iovcnt(iovcnt) {}
+
+    static void Handle(Writev &w) {
+        w.writen = writev(w.fd, w.iov, w.iovcnt);
+    }
+
+    ssize_t ReturnValue() {
+        return writen;
+    }
+
+    int fd;
+    const struct iovec *iov;
+    int iovcnt;
+
+    ssize_t writen = 0;
+};
+
+struct Preadv : Job<Preadv, ssize_t> {
+    Preadv(int fd, const struct iovec *iov, int iovcnt, off_t offset)
+        : fd(fd), iov(iov), iovcnt(iovcnt), offset(offset) {}
+
+    static void Handle(Preadv &r) {
+        r.readn = preadv(r.fd, r.iov, r.iovcnt, r.offset);
+    }
+
+    ssize_t ReturnValue() {
+        return readn;
+    }
+
+    int fd;
+    const struct iovec *iov;
+    int iovcnt;
+    off_t offset;
+
+    ssize_t readn = 0;
+};
+
+struct Pwritev : Job<Pwritev, ssize_t> {
+    Pwritev(int fd, const struct iovec *iov, int iovcnt, off_t offset)
+        : fd(fd), iov(iov), iovcnt(iovcnt), offset(offset) {}
+
+    static void Handle(Pwritev &w) {
+        w.writen = pwritev(w.fd, w.iov, w.iovcnt, w.offset);
+    }
+
+    ssize_t ReturnValue() {
+        return writen;
+    }
+
+    int fd;
+    const struct iovec *iov;
+    int iovcnt;
+    off_t offset;
+
+    ssize_t writen = 0;
+};
+
+struct Fsync : Job<Fsync, int> {
+    Fsync(int fd) : fd(fd) {}
+
+    static void Handle(Fsync &f) {
+        f.result = fsync(f.fd);
+    }
+
+    int ReturnValue() {
+        return result;
+    }
+
+    int fd;
+
+    int result = 0;
+};
+
+// falls back to fsync where fdatasync isn't available
+struct Fdatasync : Job<Fdatasync, int> {
+    Fdatasync(int fd) : fd(fd) {}
+
+    static void Handle(Fdatasync &f) {
+#ifdef __linux__
+        f.result = fdatasync(f.fd);
+#else
+        f.result = fsync(f.fd);
+#endif // __linux__
+    }
+
+    int ReturnValue() {
+        return result;
+    }
+
+    int fd;
+
+    int result = 0;
+};
+
+struct Close : Job<Close, int> {
+    Close(int fd) : fd(fd) {}
+
+    static void Handle(Close &c) {
+        c.result = close(c.fd);
+    }
+
+    int ReturnValue() {
+        return result;
+    }
+
+    int fd;
+
+    int result = 0;
+};
+
+#ifdef __linux__
+
+// `offset` of -1 reads at the current file offset, `flags` are RWF_*
+struct Preadv2 : Job<Preadv2, ssize_t> {
+    Preadv2(
+        int fd, const struct iovec *iov, int iovcnt, off_t offset, int flags)
+        : fd(fd), iov(iov), iovcnt(iovcnt), offset(offset), flags(flags) {}
+
+    static void Handle(Preadv2 &r) {
+        r.readn = preadv2(r.fd, r.iov, r.iovcnt, r.offset, r.flags);
+    }
+
+    ssize_t ReturnValue() {
+        return readn;
+    }
+
+    int fd;
+    const struct iovec *iov;
+    int iovcnt;
+    off_t offset;
+    int flags;
+
+    ssize_t readn = 0;
+};
+
+namespace detail {
+
+// Repeats a partial transfer until `count` bytes are moved, the source is
+// exhausted or an error occurs after which the bytes moved so far are kept.
+// EINTR is an error too, so a cancellation stops the loop.
+template <typename F>
+ssize_t TransferAll(size_t count, F step) {
+    size_t total = 0;
+    for (; total < count;) {
+        ssize_t n = step(count - total);
+        if (n > 0) {
+            total += n;
+        } else if (n == 0 or total > 0) {
+            break;
+        } else {
+            return -1;
+        }
+    }
+    return total;
+}
+
+} // namespace detail
+
+// `offset` may be null to use and update the file offset of `in_fd`
+struct Sendfile : Job<Sendfile, ssize_t> {
+    Sendfile(int out_fd, int in_fd, off_t *offset, size_t count)
+        : out_fd(out_fd), in_fd(in_fd), offset(offset), count(count) {}
+
+    static void Handle(Sendfile &s) {
+        s.sent = detail::TransferAll(s.count, [&s](size_t left) {
+            return sendfile(s.out_fd, s.in_fd, s.offset, left);
+        });
+    }
+
+    ssize_t ReturnValue() {
+        return sent;
+    }
+
+    int out_fd;
+    int in_fd;
+    off_t *offset;
+    size_t count;
+
+    ssize_t sent = 0;
+};
+
+// One of the two fds must be a pipe, offsets must be null for pipes. When
+// splicing into a pipe nobody drains, `len` must fit the pipe capacity.
+struct Splice : Job<Splice, ssize_t> {
+    Splice(
+        int fd_in, loff_t *off_in, int fd_out, loff_t *off_out, size_t len,
+        unsigned int flags)
+        : fd_in(fd_in), off_in(off_in), fd_out(fd_out), off_out(off_out),
+          len(len), flags(flags) {}
+
+    static void Handle(Splice &s) {
+        s.moved = detail::TransferAll(s.len, [&s](size_t left) {
+            return splice(
+                s.fd_in, s.off_in, s.fd_out, s.off_out, left, s.flags);
+        });
+    }
+
+    ssize_t ReturnValue() {
+        return moved;
+    }
+
+    int fd_in;
+    loff_t *off_in;
+    int fd_out;
+    loff_t *off_out;
+    size_t len;
+    unsigned int flags;
+
+    ssize_t moved = 0;
+};
+
+// Duplicates pipe content without consuming it. A second tee() would copy
+// the same bytes again, so unlike the others this is a single call.
+struct Tee : Job<Tee, ssize_t> {
+    Tee(int fd_in, int fd_out, size_t len, unsigned int flags)
+        : fd_in(fd_in), fd_out(fd_out), len(len), flags(flags) {}
+
+    static void Handle(Tee &t) {
+        t.copied = tee(t.fd_in, t.fd_out, t.len, t.flags);
+    }
+
+    ssize_t ReturnValue() {
+        return copied;
+    }
+
+    int fd_in;
+    int fd_out;
+    size_t len;
+    unsigned int flags;
+
+    ssize_t copied = 0;
+};
+
+struct CopyFileRange : Job<CopyFileRange, ssize_t> {
+    CopyFileRange(
+        int fd_in, loff_t *off_in, int fd_out, loff_t *off_out, size_t len,
+        unsigned int flags = 0)
+        : fd_in(fd_in), off_in(off_in), fd_out(fd_out), off_out(off_out),
+          len(len), flags(flags) {}
+
+    static void Handle(CopyFileRange &c) {
+        c.copied = detail::TransferAll(c.len, [&c](size_t left) {
+            return copy_file_range(
+                c.fd_in, c.off_in, c.fd_out, c.off_out, left, c.flags);
+        });
+    }
+
+    ssize_t ReturnValue() {
+        return copied;
+    }
+
+    int fd_in;
+    loff_t *off_in;
+    int fd_out;
+    loff_t *off_out;
+    size_t len;
+    unsigned int flags;
+
+    ssize_t copied = 0;
+};
+
+struct SyncFileRange : Job<SyncFileRange, int> {
+    SyncFileRange(int fd, off_t offset, off_t nbytes, unsigned int flags)
+        : fd(fd), offset(offset), nbytes(nbytes), flags(flags) {}
+
+    static void Handle(SyncFileRange &s) {
+        s.result = sync_file_range(s.fd, s.offset, s.nbytes, s.flags);
+    }
+
+    int ReturnValue() {
+        return result;
+    }
+
+    int fd;
+    off_t offset;
+    off_t nbytes;
+    unsigned int flags;
+
+    int result = 0;
+};
+
+#endif // __linux__
+
 } // namespace conjure::io::job
 
 #endif // CONJURE_IO_OPERATION_H_
@@ -68,7 +68,7 @@ class SyncQueue {
 
     bool Push(const T &val) {
         Lock::Guard hold(tail_lock_);
-        UnsyncPush(val);
+        return UnsyncPush(val);
     }
 
     bool UnsyncPush(const T &val) {
@@ -87,7 +87,23 @@ class SyncQueue {
 
     bool Pop(T &store) {
         Lock::Guard hold(head_lock_);
-        UnsyncPop(store);
+        return UnsyncPop(store);
+    }
+
+    // Overwrites the first queued element matching `pred`. Safe against
+    // concurrent Pop() but not UnsyncPop().
+    template <typename P>
+    bool Replace(P pred, const T &replacement) {
+        Lock::Guard hold(head_lock_);
+        int n = size_;
+        for (int i = 0, place = head_; i < n; ++i, ++place) {
+            place %= capacity_;
+            if (pred(data_[place])) {
+                data_[place] = replacement;
+                return true;
+            }
+        }
+        return false;
     }
 
     bool UnsyncPop(T &store) {
@@ -4,9 +4,18 @@
 #include "conjure/io/job.h"
 #include "conjure/io/sync-queue.h"
 #include "conjure/log.h"
+#include "conjure/thread-config.h"
+#include <pthread.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
 #include <chrono>
+#include <condition_variable>
 #include <limits>
 #include <memory>
+#include <mutex>
+#include <string>
 #include <thread>
 #include <vector>
 
@@ -17,24 +26,118 @@ class Worker {
     using Queue = SyncQueue<PrimJob>;
     using Pointer = std::unique_ptr<Worker>;
 
-    Worker(int id, int queue_size = Queue::kDefaultCapacity)
-        : id_(id), queue_(queue_size) {}
+    // the default signal interrupting a worker running a cancelled job, its
+    // default action is to ignore it so stray ones are harmless
+    static constexpr int kDefaultCancelSignal = SIGURG;
 
-    template <typename JobImpl, typename R>
-    bool Submit(Job<JobImpl, R> &job) {
-        return queue_.UnsyncPush(job.ToPrimitive());
+    // how often the signal is sent again until the worker left the syscall
+    static constexpr std::chrono::microseconds kInterruptInterval{100};
+
+    // empty polls before an idle worker blocks until the next submit
+    static constexpr int kDefaultIdleSpins = 4096;
+
+    // With `numa_local` the queue is allocated by the worker thread itself
+    // once it's placed, so that first touch puts it on the worker's node. A
+    // negative `idle_spins` keeps the worker polling while idle.
+    Worker(
+        int id, int queue_size = Queue::kDefaultCapacity,
+        ThreadConfig thread = {}, bool numa_local = false,
+        int idle_spins = kDefaultIdleSpins)
+        : id_(id), queue_size_(queue_size), thread_config_(std::move(thread)),
+          numa_local_(numa_local), idle_spins_(idle_spins) {
+        if (not numa_local_) {
+            queue_ = std::make_unique<Queue>(queue_size_);
+        }
+    }
+
+    // Any thread may submit, every one running a scheduler does. Returns
+    // false if the queue is full, the job isn't taken then.
+    bool Submit(JobBase &job) {
+        job.worker_ = this;
+        job.StampNow(JobBase::kSubmitted);
+        if (not queue_->Push(job.ToPrimitive())) {
+            return false;
+        }
+        WakeIdle();
+        return true;
+    }
+
+    // Drops the job if it is still queued, otherwise interrupts its syscall
+    // with CancelSignal(). A job popped but not started is completed by the
+    // worker without its syscall as soon as it gets to it. Never blocks,
+    // returns false if the job already finished running.
+    bool Cancel(JobBase &job) {
+        PrimJob prim = job.ToPrimitive();
+        if (queue_->Replace(
+                [&prim](const PrimJob &j) { return j.param == prim.param; },
+                PrimJob::Noop())) {
+            job.phase_.store(JobBase::kCancelled, std::memory_order_release);
+            job.Complete();
+            return true;
+        }
+        // popped, the worker either hasn't started it yet or is running it
+        int p = JobBase::kQueued;
+        if (job.phase_.compare_exchange_strong(
+                p, JobBase::kCancelled, std::memory_order_acq_rel)) {
+            return true;
+        }
+        if (p == JobBase::kRunning and
+            job.phase_.compare_exchange_strong(
+                p, JobBase::kSignalling, std::memory_order_acq_rel)) {
+            Interrupt(job);
+            return true;
+        }
+        return false;
+    }
+
+    // Sets the signal interrupting workers, which gets a handler chaining to
+    // the one installed before. Returns false once the handler is installed,
+    // by the first worker started.
+    static bool ConfigureCancelSignal(int signo) {
+        std::lock_guard<std::mutex> hold(SignalLock());
+        if (SignalInstalled()) {
+            return false;
+        }
+        CancelSignalNumber() = signo;
+        return true;
+    }
+
+    static int CancelSignal() {
+        return CancelSignalNumber();
     }
 
     bool Available() const {
-        return not queue_.Full();
+        return not queue_->Full();
     }
 
+    // counts the running job too, a worker blocked in a syscall is not idle
     int PendingJob() const {
-        return queue_.Size();
+        return queue_->Size() + running_;
+    }
+
+    int Id() const {
+        return id_;
+    }
+
+    // what was asked for
+    const ThreadConfig &GetThreadConfig() const {
+        return thread_config_;
+    }
+
+    // what the thread actually got, empty before Start()
+    ThreadConfig Placement() {
+        if (not thread_.joinable()) {
+            return {};
+        }
+        return ThreadConfig::Of(thread_.native_handle());
     }
 
     void Stop() {
         should_stop_ = true;
+        {
+            std::lock_guard<std::mutex> lock(idle_mu_);
+            idle_cv_.notify_one();
+        }
         thread_.join();
         CONJURE_LOGF("worker %d stopped", id_);
     }
@@ -44,43 +147,234 @@ class Worker {
             // already started
             return;
         }
-        thread_ = std::thread([this]() { ProcessJobs(); });
+        InstallCancelHandler();
+        thread_ = std::thread([this]() {
+            if (not thread_config_.ApplyToCurrent()) {
+                CONJURE_LOGF("worker %d: thread config partly rejected", id_);
+            }
+            if (numa_local_) {
+                queue_ = std::make_unique<Queue>(queue_size_);
+            }
+            CreateInterruptTimer();
+            ready_.store(true, std::memory_order_release);
+            ProcessJobs();
+            DeleteInterruptTimer();
+        });
+        for (; not ready_.load(std::memory_order_acquire);) {
+            std::this_thread::yield();
+        }
     }
 
   private:
     void ProcessJobs() {
-        for (;;) {
+        for (int idle = 0;;) {
             if (should_stop_) {
                 break;
             }
             PrimJob j;
             if (TryGetJob(j)) {
+                idle = 0;
+                running_ = 1;
                 j.Call();
-            } else {
-                // std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                running_ = 0;
+                // signals still pending are handled on the way back from
+                // the syscall disarming, before the next job
+                if (interrupt_armed_.exchange(
+                        false, std::memory_order_acquire)) {
+                    SetInterruptTimer(std::chrono::microseconds(0));
+                }
+            } else if (idle_spins_ >= 0 and ++idle > idle_spins_) {
+                idle = 0;
+                BlockIdle();
             }
         }
     }
 
+    // the submitter looks at `sleeping_` after pushing, and the worker at the
+    // queue after setting it, so one of them sees the other
+    void BlockIdle() {
+        std::unique_lock<std::mutex> lock(idle_mu_);
+        sleeping_.store(true, std::memory_order_seq_cst);
+        idle_cv_.wait(
+            lock, [this] { return not queue_->Empty() or should_stop_; });
+        sleeping_.store(false, std::memory_order_relaxed);
+    }
+
+    void WakeIdle() {
+        if (sleeping_.load(std::memory_order_seq_cst)) {
+            std::lock_guard<std::mutex> lock(idle_mu_);
+            idle_cv_.notify_one();
+        }
+    }
+
     bool TryGetJob(PrimJob &j) {
-        if (not queue_.Empty()) {
-            queue_.UnsyncPop(j);
-            return true;
+        if (not queue_->Empty()) {
+            // locked to agree with Cancel() on who owns the job
+            return queue_->Pop(j);
         }
         return false;
     }
 
-    [[maybe_unused]] int id_;
-    Queue queue_;
+    // A signal landing before the worker entered the syscall is lost, so the
+    // worker's timer sends it again every kInterruptInterval until the worker
+    // left the syscall and disarmed it; the canceller doesn't wait. The job is
+    // held in kSignalling meanwhile, the worker can't acknowledge and disarm
+    // before the timer is armed.
+    void Interrupt(JobBase &job) {
+        interrupt_armed_.store(true, std::memory_order_relaxed);
+        SetInterruptTimer(kInterruptInterval);
+        pthread_kill(thread_.native_handle(), CancelSignal());
+        job.phase_.store(JobBase::kInterrupting, std::memory_order_release);
+    }
+
+    // A timer signalling the worker thread only, created by the thread
+    // itself. Elsewhere the signal is sent once.
+    void CreateInterruptTimer() {
+#ifdef __linux__
+        struct sigevent event = {};
+        event.sigev_notify = SIGEV_THREAD_ID;
+        event.sigev_signo = CancelSignal();
+        event._sigev_un._tid = gettid();
+        has_interrupt_timer_ =
+            timer_create(CLOCK_MONOTONIC, &event, &interrupt_timer_) == 0;
+        if (not has_interrupt_timer_) {
+            CONJURE_LOGF("worker %d: no interrupt timer", id_);
+        }
+#endif // __linux__
+    }
+
+    void DeleteInterruptTimer() {
+#ifdef __linux__
+        if (has_interrupt_timer_) {
+            timer_delete(interrupt_timer_);
+        }
+#endif // __linux__
+    }
+
+    // periodic from now on, zero disarms
+    void SetInterruptTimer(std::chrono::microseconds interval) {
+#ifdef __linux__
+        if (not has_interrupt_timer_) {
+            return;
+        }
+        struct timespec ts = {
+            (time_t)(interval.count() / 1000000),
+            (long)(interval.count() % 1000000 * 1000)};
+        struct itimerspec spec = {ts, ts};
+        timer_settime(interrupt_timer_, 0, &spec, nullptr);
+#endif // __linux__
+    }
+
+    static void InstallCancelHandler() {
+        std::lock_guard<std::mutex> hold(SignalLock());
+        if (SignalInstalled()) {
+            return;
+        }
+        struct sigaction action = {};
+        action.sa_sigaction = &OnCancelSignal;
+        sigemptyset(&action.sa_mask);
+        // no SA_RESTART, blocking syscalls return EINTR
+        action.sa_flags = SA_SIGINFO;
+        if (sigaction(CancelSignal(), &action, &PreviousAction()) != 0) {
+            CONJURE_LOGL("cancel signal handler rejected");
+        }
+        SignalInstalled() = true;
+    }
+
+    // interrupting the syscall is all it takes, the rest is for the handler
+    // that was there before
+    static void OnCancelSignal(int signo, siginfo_t *info, void *context) {
+        const struct sigaction &prev = PreviousAction();
+        if (prev.sa_flags & SA_SIGINFO) {
+            if (prev.sa_sigaction != nullptr) {
+                prev.sa_sigaction(signo, info, context);
+            }
+        } else if (prev.sa_handler != SIG_DFL and prev.sa_handler != SIG_IGN) {
+            prev.sa_handler(signo);
+        }
+    }
+
+    static std::mutex &SignalLock() {
+        static std::mutex lock;
+        return lock;
+    }
+
+    static int &CancelSignalNumber() {
+        static int signo = kDefaultCancelSignal;
+        return signo;
+    }
+
+    static bool &SignalInstalled() {
+        static bool installed = false;
+        return installed;
+    }
+
+    static struct sigaction &PreviousAction() {
+        static struct sigaction action = {};
+        return action;
+    }
+
+    int id_;
+    int queue_size_;
+    ThreadConfig thread_config_;
+    bool numa_local_;
+    int idle_spins_;
+    std::unique_ptr<Queue> queue_;
     std::thread thread_;
+    std::atomic<bool> ready_ = false;
     volatile bool should_stop_ = false;
+    std::atomic<int> running_ = 0;
+
+    std::atomic<bool> interrupt_armed_ = false;
+#ifdef __linux__
+    timer_t interrupt_timer_;
+    bool has_interrupt_timer_ = false;
+#endif // __linux__
+
+    std::atomic<bool> sleeping_ = false;
+    std::mutex idle_mu_;
+    std::condition_variable idle_cv_;
+};
+
+// Sizing and placement of a worker pool
+struct PoolConfig {
+    PoolConfig() = default;
+
+    PoolConfig(int size, const std::string &name = "conjure-io")
+        : size(size), name(name) {}
+
+    int size = 4;
+
+    int queue_capacity = Worker::Queue::kDefaultCapacity;
+
+    // workers are named `name`-<id>
+    std::string name = "conjure-io";
+
+    // CPU sets handed to the workers in turn, empty for unpinned workers
+    std::vector<std::vector<int>> affinity;
+
+    // allocate each worker's queue on the worker's own NUMA node
+    bool numa_local = true;
+
+    // empty polls before an idle worker blocks, negative to poll on
+    int idle_spins = Worker::kDefaultIdleSpins;
+
+    ThreadConfig ForWorker(int id) const {
+        ThreadConfig thread(name + "-" + std::to_string(id));
+        if (not affinity.empty()) {
+            thread.cpus = affinity[id % affinity.size()];
+        }
+        return thread;
+    }
 };
 
 class WorkerPool {
   public:
     WorkerPool() = default;
-    WorkerPool(int pool_size) {
-        for (int i = 0; i < pool_size; ++i) {
+    WorkerPool(int pool_size) : WorkerPool(PoolConfig(pool_size)) {}
+
+    WorkerPool(const PoolConfig &config) : config_(config) {
+        for (int i = 0; i < config_.size; ++i) {
             AddWorker();
         }
         StartAll();
@@ -90,8 +384,24 @@ class WorkerPool {
         StopAll();
     }
 
-    static WorkerPool &Instance(int pool_size = 4) {
-        static WorkerPool worker_pool(pool_size);
+    // Sets up the pool behind Instance(). Returns false once the pool is in
+    // use, the config it runs with stays as it is.
+    static bool Configure(const PoolConfig &config) {
+        std::lock_guard<std::mutex> hold(InstanceLock());
+        if (InstanceCreated()) {
+            return false;
+        }
+        InstanceConfig() = config;
+        return true;
+    }
+
+    static WorkerPool &Instance() {
+        static WorkerPool &worker_pool = []() -> WorkerPool & {
+            std::lock_guard<std::mutex> hold(InstanceLock());
+            InstanceCreated() = true;
+            static WorkerPool pool(InstanceConfig());
+            return pool;
+        }();
         return worker_pool;
     }
 
@@ -99,8 +409,15 @@ class WorkerPool {
         return workers_.size();
     }
 
+    const PoolConfig &GetConfig() const {
+        return config_;
+    }
+
     void AddWorker() {
-        workers_.push_back(std::make_unique<Worker>(Size()));
+        int id = Size();
+        workers_.push_back(std::make_unique<Worker>(
+            id, config_.queue_capacity, config_.ForWorker(id),
+            config_.numa_local, config_.idle_spins));
     }
 
     Worker &GetWorker(int n) {
@@ -129,8 +446,9 @@ class WorkerPool {
         return true;
     }
 
-    template <typename JobImpl, typename R>
-    void Submit(Job<JobImpl, R> &job) {
+    // Hands the job to the least loaded worker. With every queue full the
+    // thread retries until a worker took it, jobs are never dropped.
+    void Submit(JobBase &job) {
         int best_idx = 0;
         int least_jobs = std::numeric_limits<int>::max();
         for (int i = 0; i < workers_.size(); ++i) {
@@ -140,10 +458,56 @@ class WorkerPool {
                 best_idx = i;
             }
         }
-        workers_[best_idx]->Submit(job);
+        if (not workers_[best_idx]->Submit(job)) {
+            SubmitToAny(job);
+        }
+    }
+
+    // spreads the jobs over the workers, queue lengths are sampled once
+    void Submit(const std::vector<JobBase *> &jobs) {
+        std::vector<int> pending(workers_.size());
+        for (int i = 0; i < Size(); ++i) {
+            pending[i] = workers_[i]->PendingJob();
+        }
+        for (JobBase *job : jobs) {
+            int best_idx = std::min_element(begin(pending), end(pending)) -
+                           begin(pending);
+            if (not workers_[best_idx]->Submit(*job)) {
+                SubmitToAny(*job);
+            }
+            ++pending[best_idx];
+        }
     }
 
   private:
+    void SubmitToAny(JobBase &job) {
+        for (;;) {
+            for (auto &worker : workers_) {
+                if (worker->Submit(job)) {
+                    return;
+                }
+            }
+            CONJURE_LOGL("every worker queue full, retrying");
+            std::this_thread::yield();
+        }
+    }
+
+    static std::mutex &InstanceLock() {
+        static std::mutex lock;
+        return lock;
+    }
+
+    static PoolConfig &InstanceConfig() {
+        static PoolConfig config;
+        return config;
+    }
+
+    static bool &InstanceCreated() {
+        static bool created = false;
+        return created;
+    }
+
+    PoolConfig config_;
     std::vector<Worker::Pointer> workers_;
     bool active_ = false;
 };
@@ -0,0 +1,119 @@
+#ifndef CONJURE_OFFLOAD_H_
+#define CONJURE_OFFLOAD_H_
+
+#include "conjure/function-wrapper.h"
+#include "conjure/interfaces.h"
+#include "conjure/io/job.h"
+#include "conjure/io/worker-pool.h"
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace conjure {
+
+namespace detail {
+
+// Runs a callable on a worker. The callable and its arguments are referenced
+// from the suspended caller's frame, nothing is copied.
+template <typename F, typename... Args>
+struct OffloadJob
+    : io::Job<
+          OffloadJob<F, Args...>,
+          NormalizeVoidT<std::invoke_result_t<F, Args...>>> {
+    using R = std::invoke_result_t<F, Args...>;
+    using ResultT = NormalizeVoidT<R>;
+
+    OffloadJob(F &f, Args &&... args)
+        : f(f), args(std::forward<Args>(args)...) {}
+
+    static void Handle(OffloadJob &o) {
+        try {
+            if constexpr (std::is_void_v<R>) {
+                std::apply(o.f, std::move(o.args));
+                o.result.emplace();
+            } else {
+                o.result.emplace(std::apply(o.f, std::move(o.args)));
+            }
+        } catch (...) {
+            o.exception = std::current_exception();
+        }
+    }
+
+    ResultT ReturnValue() {
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+        return std::move(result.value());
+    }
+
+    F &f;
+    std::tuple<Args &&...> args;
+
+    std::optional<ResultT> result;
+    std::exception_ptr exception;
+};
+
+inline std::mutex &ComputePoolLock() {
+    static std::mutex lock;
+    return lock;
+}
+
+inline std::pair<io::PoolConfig, bool> &ComputePoolConfig() {
+    static std::pair<io::PoolConfig, bool> config(
+        io::PoolConfig(
+            std::max((int)std::thread::hardware_concurrency(), 1),
+            "conjure-cpu"),
+        false);
+    return config;
+}
+
+} // namespace detail
+
+// Sets up the compute pool. Returns false once the pool is in use.
+inline bool ConfigureComputePool(const io::PoolConfig &config) {
+    std::lock_guard<std::mutex> hold(detail::ComputePoolLock());
+    if (detail::ComputePoolConfig().second) {
+        return false;
+    }
+    detail::ComputePoolConfig().first = config;
+    return true;
+}
+
+// Workers for compute work, one per core by default and apart from the io
+// pool so that long computations never delay io jobs. Idle workers block
+// after `idle_spins` empty polls, so an idle pool costs no CPU.
+inline io::WorkerPool &ComputePool() {
+    static io::WorkerPool &compute_pool = []() -> io::WorkerPool & {
+        std::lock_guard<std::mutex> hold(detail::ComputePoolLock());
+        detail::ComputePoolConfig().second = true;
+        static io::WorkerPool pool(detail::ComputePoolConfig().first);
+        return pool;
+    }();
+    return compute_pool;
+}
+
+// Runs f(args...) on the compute pool, suspending only the calling coroutine,
+// and returns its result or rethrows its exception.
+template <typename F, typename... Args>
+std::invoke_result_t<F, Args...> Offload(F &&f, Args &&... args) {
+    detail::OffloadJob<std::remove_reference_t<F>, Args...> job(
+        f, std::forward<Args>(args)...);
+    ComputePool().Submit(job);
+    Suspend();
+    job.RecordLatency();
+    if constexpr (std::is_void_v<std::invoke_result_t<F, Args...>>) {
+        job.ReturnValue();
+    } else {
+        return job.ReturnValue();
+    }
+}
+
+} // namespace conjure
+
+#endif // CONJURE_OFFLOAD_H_
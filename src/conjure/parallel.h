@@ -0,0 +1,214 @@
+#ifndef CONJURE_PARALLEL_H_
+#define CONJURE_PARALLEL_H_
+
+#include "conjure/future.h"
+#include "conjure/interfaces.h"
+#include "conjure/task-group.h"
+#include "conjure/thread-config.h"
+#include <assert.h>
+#include <stddef.h>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <iterator>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Bounded-concurrency loops over ranges: a fixed set of worker coroutines
+// pull items off a shared cursor, so millions of items cost `concurrency`
+// stacks rather than one each. Items are handed out in order but finish in
+// any order.
+//
+//     ParallelForEach(urls, Fetch, 256);
+//     size_t total = ParallelReduce(
+//         files, size_t(0), FileSize, std::plus<size_t>(), 64);
+
+namespace conjure {
+
+struct ParallelConfig {
+    // worker coroutines over all threads
+    int concurrency = 64;
+
+    // Threads running workers, the calling one included. Each extra thread
+    // gets a scheduler of its own and the range must be random access.
+    int threads = 1;
+
+    Config worker = Config("worker");
+
+    ThreadConfig thread{"conjure-par"};
+};
+
+namespace detail {
+
+// Hands out the items of a range to the workers of all threads. Random
+// access ranges are indexed through an atomic, others are walked by a
+// shared iterator, which only workers of one scheduler may do.
+template <typename Range>
+class ParallelCursor {
+  public:
+    using Iter = decltype(std::begin(std::declval<Range &>()));
+
+    static constexpr bool kRandomAccess = std::is_base_of_v<
+        std::random_access_iterator_tag,
+        typename std::iterator_traits<Iter>::iterator_category>;
+
+    explicit ParallelCursor(Range &range)
+        : begin_(std::begin(range)), it_(begin_), end_(std::end(range)) {
+        if constexpr (kRandomAccess) {
+            size_ = end_ - begin_;
+        }
+    }
+
+    // visits items until the range is used up or a worker failed
+    template <typename F>
+    void ForEach(F &f) {
+        try {
+            if constexpr (kRandomAccess) {
+                for (size_t i; not failed_.load(std::memory_order_relaxed) and
+                               (i = next_.fetch_add(
+                                    1, std::memory_order_relaxed)) < size_;) {
+                    f(begin_[i]);
+                }
+            } else {
+                for (; not failed_.load(std::memory_order_relaxed) and
+                       it_ != end_;) {
+                    Iter item = it_++;
+                    f(*item);
+                }
+            }
+        } catch (...) {
+            failed_.store(true, std::memory_order_relaxed);
+            throw;
+        }
+    }
+
+  private:
+    Iter begin_;
+    Iter it_;
+    Iter end_;
+    size_t size_ = 0;
+    std::atomic<size_t> next_ = 0;
+    std::atomic<bool> failed_ = false;
+};
+
+// runs `body(w)` for w in [first, first + n) on workers of this thread
+template <typename Body>
+void RunWorkers(int first, int n, const Config &config, Body &body) {
+    TaskGroup<> group;
+    for (int w = first; w < first + n; ++w) {
+        group.Spawn(config, [&body, w] { body(w); });
+    }
+    group.WaitAll();
+}
+
+// Splits the workers over the threads, the caller keeps the first share and
+// suspends only itself for the others. Returns the number of workers.
+template <typename Body>
+int RunParallel(const ParallelConfig &config, Body body) {
+    int threads = std::max(config.threads, 1);
+    int per_thread = std::max(config.concurrency / threads, 1);
+
+    std::vector<std::thread> extra;
+    std::vector<Future<void>> done;
+    for (int t = 1; t < threads; ++t) {
+        Promise<void> promise;
+        done.push_back(promise.GetFuture());
+        extra.emplace_back(
+            [&config, &body, per_thread, t, p = std::move(promise)]() mutable {
+                config.thread.ApplyToCurrent();
+                try {
+                    RunWorkers(t * per_thread, per_thread, config.worker, body);
+                    p.SetValue();
+                } catch (...) {
+                    p.SetException(std::current_exception());
+                }
+            });
+    }
+
+    std::exception_ptr error;
+    try {
+        RunWorkers(0, per_thread, config.worker, body);
+    } catch (...) {
+        error = std::current_exception();
+    }
+    for (Future<void> &f : done) {
+        try {
+            f.Await();
+        } catch (...) {
+            if (not error) {
+                error = std::current_exception();
+            }
+        }
+    }
+    for (std::thread &t : extra) {
+        t.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    return per_thread * threads;
+}
+
+} // namespace detail
+
+// Calls f(item) for every item of `range`. Rethrows the first exception, no
+// item is handed out after it.
+template <typename Range, typename F>
+void ParallelForEach(Range &&range, F f, const ParallelConfig &config) {
+    detail::ParallelCursor<std::remove_reference_t<Range>> cursor(range);
+    assert(config.threads <= 1 or cursor.kRandomAccess);
+    detail::RunParallel(config, [&cursor, &f](int) { cursor.ForEach(f); });
+}
+
+template <typename Range, typename F>
+void ParallelForEach(Range &&range, F f, int concurrency = 64) {
+    ParallelConfig config;
+    config.concurrency = concurrency;
+    ParallelForEach(std::forward<Range>(range), std::move(f), config);
+}
+
+// Folds map(item) into a partial result per worker with `combine`, then
+// combines the partials. Which items a worker gets varies, so `combine`
+// should be associative and commutative with `init` as its identity.
+template <typename Range, typename T, typename Map, typename Combine>
+T ParallelReduce(
+    Range &&range, T init, Map map, Combine combine,
+    const ParallelConfig &config) {
+    detail::ParallelCursor<std::remove_reference_t<Range>> cursor(range);
+    assert(config.threads <= 1 or cursor.kRandomAccess);
+
+    int threads = std::max(config.threads, 1);
+    std::vector<std::optional<T>> partials(
+        std::max(config.concurrency / threads, 1) * threads);
+    detail::RunParallel(config, [&](int w) {
+        T partial = init;
+        auto fold = [&](auto &item) {
+            partial = combine(std::move(partial), map(item));
+        };
+        cursor.ForEach(fold);
+        partials[w].emplace(std::move(partial));
+    });
+
+    T result = std::move(init);
+    for (std::optional<T> &p : partials) {
+        result = combine(std::move(result), std::move(*p));
+    }
+    return result;
+}
+
+template <typename Range, typename T, typename Map, typename Combine>
+T ParallelReduce(
+    Range &&range, T init, Map map, Combine combine, int concurrency = 64) {
+    ParallelConfig config;
+    config.concurrency = concurrency;
+    return ParallelReduce(
+        std::forward<Range>(range), std::move(init), std::move(map),
+        std::move(combine), config);
+}
+
+} // namespace conjure
+
+#endif // CONJURE_PARALLEL_H_
@@ -0,0 +1,226 @@
+#ifndef CONJURE_PREFETCH_H_
+#define CONJURE_PREFETCH_H_
+
+#include "conjure/gen-iterator.h"
+#include "conjure/interfaces.h"
+#include "conjure/spsc-ring.h"
+#include "conjure/thread-config.h"
+#include <stddef.h>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <tuple>
+#include <utility>
+
+namespace conjure {
+
+struct PrefetchConfig {
+    // values the producer may run ahead of the consumer
+    size_t depth = 64;
+
+    ThreadConfig thread{"conjure-fetch"};
+};
+
+namespace detail {
+
+template <typename R>
+struct GeneratedOf;
+
+template <typename G>
+struct GeneratedOf<Generating<G>> {
+    using type = G;
+};
+
+// Either side parks only after flagging it and finding the ring still full
+// or empty, the other side clears the flag to claim the wake-up.
+template <typename G>
+struct PrefetchState {
+    explicit PrefetchState(size_t depth) : ring(depth) {}
+
+    // Producer side, blocks the thread while the ring is full. Returns false
+    // once the consumer is gone, the value is dropped then.
+    bool Push(G &&g) {
+        for (;;) {
+            if (closed.load()) {
+                return false;
+            }
+            if (ring.TryPush(std::move(g))) {
+                WakeConsumer();
+                return true;
+            }
+            producer_parked.store(true);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (closed.load() or ring.TryPush(std::move(g))) {
+                producer_parked.store(false);
+                if (closed.load()) {
+                    return false;
+                }
+                WakeConsumer();
+                return true;
+            }
+            std::unique_lock<std::mutex> lock(mu);
+            cv.wait(lock, [this] { return not producer_parked.load(); });
+        }
+    }
+
+    // `e` is rethrown to the consumer once it got every value before it
+    void Finish(std::exception_ptr e = nullptr) {
+        error = std::move(e);
+        done.store(true, std::memory_order_release);
+        WakeConsumer();
+    }
+
+    // consumer side, lets the producer run out
+    void Close() {
+        closed.store(true);
+        WakeProducer();
+    }
+
+    void WakeConsumer() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (consumer_parked.load() and consumer_parked.exchange(false)) {
+            consumer->Wake();
+        }
+    }
+
+    void WakeProducer() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (producer_parked.load() and producer_parked.exchange(false)) {
+            std::lock_guard<std::mutex> lock(mu);
+            cv.notify_one();
+        }
+    }
+
+    SpscRing<G> ring;
+    std::atomic<bool> done = false;
+    std::atomic<bool> closed = false;
+    std::exception_ptr error; // published by `done`
+
+    Conjury *consumer = nullptr;
+    std::atomic<bool> consumer_parked = false;
+
+    std::atomic<bool> producer_parked = false;
+    std::mutex mu;
+    std::condition_variable cv;
+
+    std::thread producer;
+};
+
+// Held by the consumer generator for as long as it exists, which for one
+// stopped early is until its thread's scheduler goes. Dropping it before
+// the producer finished closes the state and detaches the producer thread.
+template <typename G>
+struct PrefetchOwner {
+    explicit PrefetchOwner(std::shared_ptr<PrefetchState<G>> s)
+        : state(std::move(s)) {}
+
+    PrefetchOwner(PrefetchOwner &&o) : state(std::move(o.state)) {}
+
+    ~PrefetchOwner() {
+        if (state == nullptr) {
+            return;
+        }
+        state->Close();
+        if (state->producer.joinable()) {
+            state->producer.detach();
+        }
+    }
+
+    std::shared_ptr<PrefetchState<G>> state;
+};
+
+// Yields on the consumer's scheduler what the producer thread rings in, then
+// rethrows what the producer failed with.
+template <typename G>
+Generating<G> Prefetched(PrefetchState<G> *s) {
+    for (;;) {
+        bool done = s->done.load(std::memory_order_acquire);
+        if (std::optional<G> g = s->ring.TryPop()) {
+            s->WakeProducer();
+            YieldWith(std::move(*g));
+            continue;
+        }
+        if (done) {
+            break;
+        }
+        s->consumer_parked.store(true);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (not s->ring.Empty() or s->done.load()) {
+            if (s->consumer_parked.exchange(false)) {
+                continue;
+            }
+            // the producer claimed the flag, its wake-up is on the way
+        }
+        Suspend();
+    }
+    s->producer.join();
+    if (s->error) {
+        std::rethrow_exception(s->error);
+    }
+    return {};
+}
+
+} // namespace detail
+
+// Runs the generator f(args...) on a thread of its own, with a scheduler of
+// its own, up to `prefetch.depth` values ahead of the consumer. The returned
+// generator is iterated as usual on the calling thread; values are moved
+// through the ring, so G must be movable. The producer blocks once the ring
+// is full. A consumer that stops early leaves its generator unfinished, and
+// like any unfinished generator it's only destroyed with the scheduler of
+// its thread; until then the producer thread stays blocked and the ring
+// keeps up to `depth` values. An exception thrown by f reaches the consumer
+// after the values yielded before it.
+//
+//     for (const Record &r : Prefetch(Config{}, {}, Parse, path)) ...
+template <typename F, typename... Args>
+ConjuryClient<
+    Generating<typename detail::GeneratedOf<WrapperResultT<F, Args...>>::type>>
+    *Prefetch(
+        const Config &config, const PrefetchConfig &prefetch, F f,
+        Args... args) {
+    using G =
+        typename detail::GeneratedOf<WrapperResultT<F, Args...>>::type;
+
+    auto s = std::make_shared<detail::PrefetchState<G>>(prefetch.depth);
+    // the owner lives in the callable, which is kept until the generator is
+    // destroyed, not on the coroutine stack
+    auto co = Conjure(
+        Config{}, [owner = detail::PrefetchOwner<G>(s)]() {
+            return detail::Prefetched<G>(owner.state.get());
+        });
+    s->consumer = co;
+    s->producer = std::thread(
+        [s, thread = prefetch.thread, config, f = std::move(f),
+         args = std::make_tuple(std::move(args)...)]() mutable {
+            thread.ApplyToCurrent();
+            std::exception_ptr error;
+            // f throws on the producer's coroutine stack, catch it there
+            auto body = [&](auto &&... a) -> Generating<G> {
+                try {
+                    return f(std::forward<decltype(a)>(a)...);
+                } catch (...) {
+                    error = std::current_exception();
+                    return {};
+                }
+            };
+            auto gen = std::apply(
+                [&](auto &... a) { return Conjure(config, body, a...); },
+                args);
+            for (G g : Moving(gen)) {
+                if (not s->Push(std::move(g))) {
+                    break;
+                }
+            }
+            s->Finish(std::move(error));
+        });
+    return co;
+}
+
+} // namespace conjure
+
+#endif // CONJURE_PREFETCH_H_
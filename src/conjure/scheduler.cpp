@@ -1,10 +1,17 @@
 #include "conjure/interfaces.h"
+#include <algorithm>
 
 namespace conjure {
 
 void Scheduler::Run(Scheduler *sche) {
     for (;;) {
+        FireTimers(*sche);
+        ResumeCompleted(*sche);
         YieldFromReadyQueue(*sche);
+        if (sche->suspended_queue_.empty()) {
+            WaitCompletion(*sche);
+            continue;
+        }
         sche->UseBakSuspendedQueue();
         YieldFromSuspendedQueue(*sche);
         sche->UseMajorSuspendedQueue();
@@ -34,7 +41,6 @@ void Scheduler::YieldTo(Conjury *conjury) {
 
 Scheduler::SuspendedConjury::ActionState
 Scheduler::SuspendedConjury::ObserveState() {
-    c->ConsumeWakeUp();
     State s = c->GetState();
     if (not ready_pred) {
         printf("%s ???\n", c->Name());
@@ -57,7 +63,7 @@ void Scheduler::YieldFromReadyQueue(Scheduler &sche) {
     for (; not sche.ready_queue_.empty();) {
         Conjury *c = sche.ready_queue_.front();
         sche.ready_queue_.pop_front();
-        if (c->GetState() == State::kReady) {
+        if (state::IsExecutable(c->GetState())) {
             sche.YieldTo(c);
         } else {
             CONJURE_LOGF(
@@ -67,11 +73,85 @@ void Scheduler::YieldFromReadyQueue(Scheduler &sche) {
     }
 }
 
+void Scheduler::ResumeCompleted(Scheduler &sche) {
+    if (sche.deferred_.empty() and sche.completion_queue_.Empty()) {
+        return;
+    }
+    std::vector<Conjury *> &woken = sche.delivering_;
+    woken.swap(sche.deferred_);
+    sche.completion_queue_.Drain([&woken](Conjury *c) { woken.push_back(c); });
+    for (size_t i = 0; i < woken.size(); ++i) {
+        Conjury *c = woken[i];
+        if (c == nullptr) {
+            // destroyed by one resumed before it
+            continue;
+        }
+        switch (c->GetState()) {
+        case State::kSuspended:
+            c->ConsumeWakeUp();
+            CONJURE_LOGF("ready from completion_queue: %s", c->Name());
+            sche.YieldTo(c);
+            break;
+        case State::kFinished:
+            c->ClearWakeUp();
+            CONJURE_LOGF("completion dropped: %s", c->Name());
+            break;
+        default:
+            // woken before it got to suspend, keep the wake-up for later
+            CONJURE_LOGF(
+                "completion deferred: %s, state: %s", c->Name(),
+                state::ToString(c->GetState()));
+            sche.deferred_.push_back(c);
+        }
+    }
+    woken.clear();
+}
+
+bool Scheduler::Deliverable(const Conjury *c) {
+    return c != nullptr and (c->GetState() == State::kSuspended or
+                             c->GetState() == State::kFinished);
+}
+
+// Blocks the thread until a wake-up comes in or the next timer is due.
+// Deferred wake-ups don't count unless their conjury got to suspend since.
+void Scheduler::WaitCompletion(Scheduler &sche) {
+    if (std::any_of(
+            begin(sche.deferred_), end(sche.deferred_), &Deliverable)) {
+        return;
+    }
+    if (sche.timers_.Empty()) {
+        sche.completion_queue_.Wait();
+    } else {
+        sche.completion_queue_.WaitUntil(sche.timers_.NextDeadline());
+    }
+}
+
+void Scheduler::Forget(Conjury *c) {
+    if (not c->ClearWakeUp()) {
+        return;
+    }
+    // the wake-up is in one of the lists or still in the queue
+    completion_queue_.Drain([this](Conjury *q) { deferred_.push_back(q); });
+    std::replace(begin(deferred_), end(deferred_), c, (Conjury *)nullptr);
+    std::replace(begin(delivering_), end(delivering_), c, (Conjury *)nullptr);
+}
+
+// due timers wake their conjuries through the completion queue
+void Scheduler::FireTimers(Scheduler &sche) {
+    if (not sche.timers_.Empty()) {
+        sche.timers_.FireDue(TimerClock::now());
+    }
+}
+
 void Scheduler::YieldFromSuspendedQueue(Scheduler &sche) {
     assert(sche.ready_queue_.empty());
     assert(not sche.suspended_queue_.empty());
     int new_blocking_end = 0;
     for (int i = 0; i < sche.suspended_queue_.size(); ++i) {
+        // completions never wait behind the predicate scan
+        if (not sche.completion_queue_.Empty()) {
+            ResumeCompleted(sche);
+        }
         auto &c = sche.suspended_queue_[i];
         switch (c.ObserveState()) {
         case SuspendedConjury::kReady:
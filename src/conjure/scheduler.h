@@ -1,8 +1,10 @@
 #ifndef CONJURE_SCHEDULER_H_
 #define CONJURE_SCHEDULER_H_
 
+#include "conjure/completion-queue.h"
 #include "conjure/conjury.h"
 #include "conjure/log.h"
+#include "conjure/timer.h"
 #include <assert.h>
 #include <deque>
 #include <functional>
@@ -26,19 +28,29 @@ class Scheduler {
         ready_queue_.push_back(c);
     }
 
-    void RegisterSuspended(Conjury *c) {
-        suspended_queue_.emplace_back(c);
-    }
-
     template <typename P>
     void RegisterSuspended(Conjury *c, P p) {
         current_suspended_queue_->emplace_back(c, std::move(p));
     }
 
+    CompletionQueue<Conjury> *GetCompletionQueue() {
+        return &completion_queue_;
+    }
+
+    void AddTimer(detail::Timer *t) {
+        timers_.Push(t);
+    }
+
+    // returns false if the timer already fired
+    bool RemoveTimer(detail::Timer *t) {
+        return timers_.Remove(t);
+    }
+
+    // drops the pending wake-up of a conjury about to be destroyed
+    void Forget(Conjury *c);
+
   private:
     struct SuspendedConjury {
-        SuspendedConjury(Conjury *c) : c(c) {}
-
         template <typename P>
         SuspendedConjury(Conjury *c, P p) : c(c), ready_pred(std::move(p)) {}
 
@@ -58,6 +70,14 @@ class Scheduler {
 
     static void YieldFromSuspendedQueue(Scheduler &sche);
 
+    static void ResumeCompleted(Scheduler &sche);
+
+    static bool Deliverable(const Conjury *c);
+
+    static void WaitCompletion(Scheduler &sche);
+
+    static void FireTimers(Scheduler &sche);
+
     void YieldTo(Conjury *conjury);
 
     void UseBakSuspendedQueue(); 
@@ -71,6 +91,15 @@ class Scheduler {
     std::vector<SuspendedConjury> bak_suspended_queue_;
 
     std::vector<SuspendedConjury> *current_suspended_queue_;
+
+    CompletionQueue<Conjury> completion_queue_;
+
+    // woken before they got to suspend, looked at again on every pass
+    std::vector<Conjury *> deferred_;
+    // the wake-ups ResumeCompleted is going over, Forget() clears entries
+    std::vector<Conjury *> delivering_;
+
+    detail::TimerHeap timers_;
 };
 
 } // namespace conjure
@@ -0,0 +1,42 @@
+#ifndef CONJURE_SELECT_STATE_H_
+#define CONJURE_SELECT_STATE_H_
+
+#include <atomic>
+
+namespace conjure {
+
+class Conjury;
+
+namespace detail {
+
+// Shared by all wait sources a Select registered on. The first source to
+// claim it wins and wakes the waiter, later ones find it taken and leave
+// their value alone. Claims may come from worker threads.
+class SelectState {
+  public:
+    explicit SelectState(Conjury *waiter) : waiter_(waiter) {}
+
+    bool TryClaim(int index) {
+        int none = -1;
+        return fired_.compare_exchange_strong(
+            none, index, std::memory_order_acq_rel);
+    }
+
+    int Fired() const {
+        return fired_.load(std::memory_order_acquire);
+    }
+
+    Conjury *Waiter() const {
+        return waiter_;
+    }
+
+  private:
+    Conjury *waiter_;
+    std::atomic<int> fired_ = -1;
+};
+
+} // namespace detail
+
+} // namespace conjure
+
+#endif // CONJURE_SELECT_STATE_H_
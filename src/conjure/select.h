@@ -0,0 +1,243 @@
+#ifndef CONJURE_SELECT_H_
+#define CONJURE_SELECT_H_
+
+#include "conjure/channel.h"
+#include "conjure/interfaces.h"
+#include "conjure/io/job.h"
+#include "conjure/io/worker-pool.h"
+#include "conjure/select-state.h"
+#include "conjure/timer.h"
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace conjure {
+
+namespace detail {
+
+struct SelectCase {
+    virtual ~SelectCase() = default;
+
+    // completes the case if it can be without waiting
+    virtual bool Poll() = 0;
+
+    // registers on the source, which claims `state` with `index` when ready
+    virtual void Arm(SelectState *state, int index) = 0;
+
+    // unregisters from the source if it didn't fire
+    virtual void Disarm() = 0;
+};
+
+template <typename T>
+struct RecvCase : SelectCase {
+    RecvCase(Channel<T> &ch, std::optional<T> &out) : ch(ch), out(out) {}
+
+    bool Poll() override {
+        out = ch.TryRecv();
+        return out or ch.Closed();
+    }
+
+    void Arm(SelectState *state, int index) override {
+        waiter = {};
+        waiter.slot = &out;
+        waiter.select = state;
+        waiter.index = index;
+        ch.ParkReceiver(&waiter);
+    }
+
+    void Disarm() override {
+        ch.Unpark(&waiter);
+    }
+
+    Channel<T> &ch;
+    std::optional<T> &out;
+    typename Channel<T>::Waiter waiter;
+};
+
+template <typename T>
+struct SendCase : SelectCase {
+    SendCase(Channel<T> &ch, T &value) : ch(ch), value(value) {}
+
+    bool Poll() override {
+        return ch.Closed() or ch.TrySend(std::move(value));
+    }
+
+    void Arm(SelectState *state, int index) override {
+        waiter = {};
+        waiter.value = &value;
+        waiter.select = state;
+        waiter.index = index;
+        ch.ParkSender(&waiter);
+    }
+
+    void Disarm() override {
+        ch.Unpark(&waiter);
+    }
+
+    Channel<T> &ch;
+    T &value;
+    typename Channel<T>::Waiter waiter;
+};
+
+struct JobCase : SelectCase {
+    explicit JobCase(io::JobBase &job) : job(job) {}
+
+    bool Poll() override {
+        if (job.AssignedWorker() == nullptr) {
+            // hooked before submitting so its submitter is never woken
+            job.Unhook();
+            io::WorkerPool::Instance().Submit(job);
+        }
+        return job.Finished();
+    }
+
+    void Arm(SelectState *state, int index) override {
+        hook = {state, index};
+        if (not job.Hook(&hook) and state->TryClaim(index)) {
+            state->Waiter()->Wake();
+        }
+    }
+
+    void Disarm() override {
+        job.Unhook();
+    }
+
+    io::JobBase &job;
+    io::detail::CompletionHook hook;
+};
+
+struct TimerCase : SelectCase {
+    explicit TimerCase(TimerClock::time_point deadline)
+        : timer(deadline, ActiveConjury()) {}
+
+    bool Poll() override {
+        return TimerClock::now() >= timer.deadline;
+    }
+
+    void Arm(SelectState *state, int index) override {
+        timer.select = state;
+        timer.index = index;
+        Conjurer::Instance()->AddTimer(&timer);
+    }
+
+    void Disarm() override {
+        Conjurer::Instance()->RemoveTimer(&timer);
+    }
+
+    Timer timer;
+};
+
+struct FinishCase : SelectCase {
+    explicit FinishCase(Conjury *co) : co(co) {}
+
+    bool Poll() override {
+        return co->IsFinished();
+    }
+
+    void Arm(SelectState *state, int index) override {
+        watcher = {state, index};
+        co->WatchFinish(&watcher);
+    }
+
+    void Disarm() override {
+        co->UnwatchFinish(&watcher);
+    }
+
+    Conjury *co;
+    FinishWatcher watcher;
+};
+
+} // namespace detail
+
+// Waits for whichever of several sources is ready first. Each Add-like call
+// returns the index Wait() reports when that source wins; when several are
+// ready at once the one added first wins. The waiting coroutine is parked on
+// every source and unregistered from the losers when it resumes, the
+// scheduler never polls it. A Select belongs to the coroutine creating it.
+//
+//     Select select;
+//     int got = select.Recv(requests, request);
+//     int timeout = select.Timeout(std::chrono::milliseconds(100));
+//     if (select.Wait() == timeout) ...
+class Select {
+  public:
+    Select() = default;
+
+    Select(const Select &) = delete;
+    Select &operator=(const Select &) = delete;
+
+    // fires with a value in `out`, or with `out` empty once `ch` is closed
+    template <typename T>
+    int Recv(Channel<T> &ch, std::optional<T> &out) {
+        return Add(std::make_unique<detail::RecvCase<T>>(ch, out));
+    }
+
+    // Fires once `value` was moved into `ch`, or when `ch` gets closed which
+    // leaves `value` alone.
+    template <typename T>
+    int Send(Channel<T> &ch, T &value) {
+        return Add(std::make_unique<detail::SendCase<T>>(ch, value));
+    }
+
+    // Fires when `job` finished. Jobs not yet submitted are submitted by the
+    // select, they must not go through a Batch or another submitter. A job
+    // that didn't win keeps running and may be selected on again.
+    int Complete(io::JobBase &job) {
+        return Add(std::make_unique<detail::JobCase>(job));
+    }
+
+    int Deadline(TimerClock::time_point deadline) {
+        return Add(std::make_unique<detail::TimerCase>(deadline));
+    }
+
+    template <typename Rep, typename Period>
+    int Timeout(std::chrono::duration<Rep, Period> d) {
+        return Deadline(TimerClock::now() + d);
+    }
+
+    // fires when `co` finished, it still has to be waited for
+    int Finish(Conjury *co) {
+        return Add(std::make_unique<detail::FinishCase>(co));
+    }
+
+    // the index of a ready source, -1 if none is
+    int TryWait() {
+        for (int i = 0; i < (int)cases_.size(); ++i) {
+            if (cases_[i]->Poll()) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    // suspends until a source is ready and returns its index, -1 if there
+    // are no sources
+    int Wait() {
+        if (int ready = TryWait(); ready != -1 or cases_.empty()) {
+            return ready;
+        }
+        detail::SelectState state(ActiveConjury());
+        for (int i = 0; i < (int)cases_.size(); ++i) {
+            cases_[i]->Arm(&state, i);
+        }
+        Suspend();
+        for (auto &c : cases_) {
+            c->Disarm();
+        }
+        return state.Fired();
+    }
+
+  private:
+    int Add(std::unique_ptr<detail::SelectCase> c) {
+        cases_.push_back(std::move(c));
+        return cases_.size() - 1;
+    }
+
+    std::vector<std::unique_ptr<detail::SelectCase>> cases_;
+};
+
+} // namespace conjure
+
+#endif // CONJURE_SELECT_H_
@@ -0,0 +1,86 @@
+#ifndef CONJURE_SPSC_RING_H_
+#define CONJURE_SPSC_RING_H_
+
+#include <stddef.h>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <utility>
+
+namespace conjure::detail {
+
+// Bounded single-producer single-consumer ring. Each side keeps a stale copy
+// of the other's index and rereads it only when it looks full or empty.
+template <typename T>
+class SpscRing {
+  public:
+    explicit SpscRing(size_t capacity)
+        : mask_(RoundUp(capacity) - 1),
+          slots_(std::make_unique<std::optional<T>[]>(mask_ + 1)) {}
+
+    SpscRing(const SpscRing &) = delete;
+    SpscRing &operator=(const SpscRing &) = delete;
+
+    // leaves `t` alone when full
+    bool TryPush(T &&t) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_seen_ > mask_) {
+            head_seen_ = head_.load(std::memory_order_acquire);
+            if (tail - head_seen_ > mask_) {
+                return false;
+            }
+        }
+        slots_[tail & mask_].emplace(std::move(t));
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    std::optional<T> TryPop() {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_seen_) {
+            tail_seen_ = tail_.load(std::memory_order_acquire);
+            if (head == tail_seen_) {
+                return std::nullopt;
+            }
+        }
+        std::optional<T> &slot = slots_[head & mask_];
+        std::optional<T> t(std::move(slot));
+        slot.reset();
+        head_.store(head + 1, std::memory_order_release);
+        return t;
+    }
+
+    // exact only on the consumer side
+    bool Empty() const {
+        return head_.load(std::memory_order_acquire) ==
+               tail_.load(std::memory_order_acquire);
+    }
+
+    size_t Capacity() const {
+        return mask_ + 1;
+    }
+
+  private:
+    static size_t RoundUp(size_t n) {
+        size_t p = 1;
+        for (; p < n;) {
+            p <<= 1;
+        }
+        return p;
+    }
+
+    const size_t mask_;
+    std::unique_ptr<std::optional<T>[]> slots_;
+
+    // consumer side
+    alignas(64) std::atomic<size_t> head_ = 0;
+    size_t tail_seen_ = 0;
+
+    // producer side
+    alignas(64) std::atomic<size_t> tail_ = 0;
+    size_t head_seen_ = 0;
+};
+
+} // namespace conjure::detail
+
+#endif // CONJURE_SPSC_RING_H_
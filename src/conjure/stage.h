@@ -56,6 +56,18 @@ class Stage {
         return true;
     }
 
+    // one pass over the stage for all of `cos` rather than a search each
+    int Destroy(std::vector<const Conjury *> cos) {
+        std::sort(begin(cos), end(cos));
+        auto gone = std::remove_if(
+            begin(conjuries_), end(conjuries_), [&cos](const auto &cop) {
+                return std::binary_search(begin(cos), end(cos), cop.get());
+            });
+        int n = end(conjuries_) - gone;
+        conjuries_.erase(gone, end(conjuries_));
+        return n;
+    }
+
   private:
     static void SetState(Conjury *conjury, State s) {
         conjury->UnsafeSetState(s);
@@ -0,0 +1,291 @@
+#ifndef CONJURE_SYNC_H_
+#define CONJURE_SYNC_H_
+
+#include "conjure/interfaces.h"
+#include "conjure/wait-list.h"
+#include <assert.h>
+
+// Blocking primitives for coroutines of one scheduler. Uncontended calls
+// only touch a counter; contended ones park the coroutine in the primitive's
+// own FIFO and the releasing side hands it over straight to the ready queue,
+// so waiters are served in arrival order and never polled.
+
+namespace conjure {
+
+namespace detail {
+
+struct SyncWaiter {
+    Conjury *conjury = ActiveConjury();
+    bool exclusive = false;
+    SyncWaiter *prev = nullptr;
+    SyncWaiter *next = nullptr;
+};
+
+inline void Park(WaitList<SyncWaiter> &list, bool exclusive = false) {
+    SyncWaiter w;
+    w.exclusive = exclusive;
+    list.PushBack(&w);
+    Suspend();
+}
+
+inline bool UnparkOne(WaitList<SyncWaiter> &list) {
+    SyncWaiter *w = list.PopFront();
+    if (w == nullptr) {
+        return false;
+    }
+    Conjurer::Instance()->Ready(w->conjury);
+    return true;
+}
+
+inline int UnparkAll(WaitList<SyncWaiter> &list) {
+    int n = 0;
+    for (; UnparkOne(list);) {
+        ++n;
+    }
+    return n;
+}
+
+} // namespace detail
+
+// Satisfies Lockable, so std::lock_guard and std::unique_lock work. Unlocking
+// with waiters hands the lock to the first of them.
+class Mutex {
+  public:
+    Mutex() = default;
+    Mutex(const Mutex &) = delete;
+    Mutex &operator=(const Mutex &) = delete;
+
+    void lock() {
+        if (not locked_) {
+            locked_ = true;
+            return;
+        }
+        detail::Park(waiters_);
+        // handed over, still locked
+    }
+
+    bool try_lock() {
+        if (locked_) {
+            return false;
+        }
+        locked_ = true;
+        return true;
+    }
+
+    void unlock() {
+        assert(locked_);
+        if (not detail::UnparkOne(waiters_)) {
+            locked_ = false;
+        }
+    }
+
+  private:
+    bool locked_ = false;
+    detail::WaitList<detail::SyncWaiter> waiters_;
+};
+
+// Readers share, writers are exclusive. Once a writer queues up new readers
+// queue behind it, so writers can't starve.
+class SharedMutex {
+  public:
+    SharedMutex() = default;
+    SharedMutex(const SharedMutex &) = delete;
+    SharedMutex &operator=(const SharedMutex &) = delete;
+
+    void lock() {
+        if (not try_lock()) {
+            detail::Park(waiters_, true);
+        }
+    }
+
+    bool try_lock() {
+        if (writer_ or readers_ > 0) {
+            return false;
+        }
+        writer_ = true;
+        return true;
+    }
+
+    void unlock() {
+        assert(writer_);
+        writer_ = false;
+        HandOver();
+    }
+
+    void lock_shared() {
+        if (not try_lock_shared()) {
+            detail::Park(waiters_, false);
+        }
+    }
+
+    bool try_lock_shared() {
+        if (writer_ or not waiters_.Empty()) {
+            return false;
+        }
+        ++readers_;
+        return true;
+    }
+
+    void unlock_shared() {
+        assert(readers_ > 0);
+        if (--readers_ == 0) {
+            HandOver();
+        }
+    }
+
+  private:
+    // to the first writer or to all readers queued before the next writer
+    void HandOver() {
+        detail::SyncWaiter *w = waiters_.Front();
+        if (w != nullptr and w->exclusive) {
+            writer_ = true;
+            detail::UnparkOne(waiters_);
+            return;
+        }
+        for (; (w = waiters_.Front()) != nullptr and not w->exclusive;) {
+            ++readers_;
+            detail::UnparkOne(waiters_);
+        }
+    }
+
+    bool writer_ = false;
+    int readers_ = 0;
+    detail::WaitList<detail::SyncWaiter> waiters_;
+};
+
+class Semaphore {
+  public:
+    explicit Semaphore(int count) : count_(count) {}
+
+    Semaphore(const Semaphore &) = delete;
+    Semaphore &operator=(const Semaphore &) = delete;
+
+    void Acquire() {
+        if (not TryAcquire()) {
+            detail::Park(waiters_);
+            // handed a permit
+        }
+    }
+
+    bool TryAcquire() {
+        // queued waiters come first
+        if (count_ == 0 or not waiters_.Empty()) {
+            return false;
+        }
+        --count_;
+        return true;
+    }
+
+    void Release(int n = 1) {
+        for (; n > 0 and detail::UnparkOne(waiters_);) {
+            --n;
+        }
+        count_ += n;
+    }
+
+    int Available() const {
+        return count_;
+    }
+
+  private:
+    int count_;
+    detail::WaitList<detail::SyncWaiter> waiters_;
+};
+
+// Waits for a number of tasks to call Done().
+class WaitGroup {
+  public:
+    explicit WaitGroup(int count = 0) : count_(count) {}
+
+    WaitGroup(const WaitGroup &) = delete;
+    WaitGroup &operator=(const WaitGroup &) = delete;
+
+    void Add(int n = 1) {
+        count_ += n;
+    }
+
+    void Done() {
+        assert(count_ > 0);
+        if (--count_ == 0) {
+            detail::UnparkAll(waiters_);
+        }
+    }
+
+    void Wait() {
+        if (count_ > 0) {
+            detail::Park(waiters_);
+        }
+    }
+
+    int Count() const {
+        return count_;
+    }
+
+  private:
+    int count_;
+    detail::WaitList<detail::SyncWaiter> waiters_;
+};
+
+// Parks `n` coroutines until the last of them arrives, then starts over.
+class Barrier {
+  public:
+    explicit Barrier(int n) : n_(n) {}
+
+    Barrier(const Barrier &) = delete;
+    Barrier &operator=(const Barrier &) = delete;
+
+    // returns true for the coroutine that arrived last
+    bool ArriveAndWait() {
+        if (++arrived_ == n_) {
+            arrived_ = 0;
+            detail::UnparkAll(waiters_);
+            return true;
+        }
+        detail::Park(waiters_);
+        return false;
+    }
+
+  private:
+    int n_;
+    int arrived_ = 0;
+    detail::WaitList<detail::SyncWaiter> waiters_;
+};
+
+// Works with Mutex, std::unique_lock<Mutex> or anything with lock/unlock.
+class ConditionVariable {
+  public:
+    ConditionVariable() = default;
+    ConditionVariable(const ConditionVariable &) = delete;
+    ConditionVariable &operator=(const ConditionVariable &) = delete;
+
+    template <typename Lock>
+    void Wait(Lock &lock) {
+        detail::SyncWaiter w;
+        waiters_.PushBack(&w);
+        lock.unlock();
+        Suspend();
+        lock.lock();
+    }
+
+    template <typename Lock, typename P>
+    void Wait(Lock &lock, P pred) {
+        for (; not pred();) {
+            Wait(lock);
+        }
+    }
+
+    void NotifyOne() {
+        detail::UnparkOne(waiters_);
+    }
+
+    void NotifyAll() {
+        detail::UnparkAll(waiters_);
+    }
+
+  private:
+    detail::WaitList<detail::SyncWaiter> waiters_;
+};
+
+} // namespace conjure
+
+#endif // CONJURE_SYNC_H_
@@ -0,0 +1,298 @@
+#ifndef CONJURE_TASK_GRAPH_H_
+#define CONJURE_TASK_GRAPH_H_
+
+#include "conjure/interfaces.h"
+#include "conjure/offload.h"
+#include "conjure/sync.h"
+#include "conjure/task-group.h"
+#include <assert.h>
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Runs a DAG of coroutine functions, each node starting as soon as the
+// nodes it depends on finished. Nodes passed as arguments to another node
+// are its dependencies and hand it their results by reference.
+//
+//     TaskGraph graph;
+//     auto a = graph.Add("fetch a", Fetch, "a");
+//     auto b = graph.Add("fetch b", Fetch, "b");
+//     auto j = graph.AddCpu("join", Join, a, b);
+//     auto c = graph.Add("fetch c", FetchBy, j);
+//     graph.Run();
+//     Use(graph.Result(c));
+//
+// Nodes run on a fixed set of executor coroutines that take ready nodes one
+// after another, so a node costs no stack of its own. CPU-bound nodes added
+// with AddCpu() run on the compute pool while the executors go on with I/O.
+
+namespace conjure {
+
+using TaskClock = std::chrono::steady_clock;
+
+namespace detail {
+
+struct GraphNode {
+    virtual ~GraphNode() = default;
+
+    virtual void Execute() = 0;
+
+    std::string name;
+    bool cpu = false;
+    std::vector<int> deps;
+    std::vector<int> dependents;
+    int unfinished = 0;
+
+    TaskClock::time_point start;
+    TaskClock::time_point end;
+};
+
+template <typename R>
+struct ResultNode : GraphNode {
+    std::optional<NormalizeVoidT<R>> result;
+};
+
+} // namespace detail
+
+// a node of a TaskGraph producing an R
+template <typename R>
+struct TaskNode {
+    int id;
+    detail::ResultNode<R> *node;
+};
+
+namespace detail {
+
+template <typename A>
+struct IsTaskNode : std::false_type {};
+
+template <typename R>
+struct IsTaskNode<TaskNode<R>> : std::true_type {};
+
+template <typename A>
+const auto &ResolveArg(const A &a) {
+    if constexpr (IsTaskNode<A>::value) {
+        return *a.node->result;
+    } else {
+        return a;
+    }
+}
+
+template <typename R, typename F, typename... Args>
+struct CallNode : ResultNode<R> {
+    CallNode(F f, Args... args)
+        : f(std::move(f)), args(std::move(args)...) {}
+
+    void Execute() override {
+        if (this->cpu) {
+            this->result.emplace(Offload([this] { return Call(); }));
+        } else {
+            this->result.emplace(Call());
+        }
+    }
+
+    NormalizeVoidT<R> Call() {
+        return std::apply(
+            [this](const auto &... a) -> NormalizeVoidT<R> {
+                if constexpr (std::is_void_v<R>) {
+                    f(ResolveArg(a)...);
+                    return {};
+                } else {
+                    return f(ResolveArg(a)...);
+                }
+            },
+            args);
+    }
+
+    F f;
+    std::tuple<Args...> args;
+};
+
+} // namespace detail
+
+// a node of the critical path
+struct CriticalStep {
+    std::string name;
+    TaskClock::duration wait; // since the previous step ended
+    TaskClock::duration run;
+};
+
+class TaskGraph {
+  public:
+    TaskGraph() = default;
+
+    TaskGraph(const TaskGraph &) = delete;
+    TaskGraph &operator=(const TaskGraph &) = delete;
+
+    // `f` runs on an executor coroutine and may suspend
+    template <typename F, typename... Args>
+    auto Add(std::string name, F f, Args... args) {
+        using R = std::invoke_result_t<
+            F &, decltype(detail::ResolveArg(std::declval<Args &>()))...>;
+        auto node = std::make_unique<detail::CallNode<R, F, Args...>>(
+            std::move(f), std::move(args)...);
+        TaskNode<R> handle{Size(), node.get()};
+        node->name = std::move(name);
+        nodes_.push_back(std::move(node));
+        (AddArgDep(handle.id, args), ...);
+        return handle;
+    }
+
+    // `f` is CPU-bound and runs on the compute pool
+    template <typename F, typename... Args>
+    auto AddCpu(std::string name, F f, Args... args) {
+        auto handle = Add(std::move(name), std::move(f), std::move(args)...);
+        handle.node->cpu = true;
+        return handle;
+    }
+
+    // An ordering edge that passes no data. `on` must have been added before
+    // `node`, which keeps the graph acyclic; throws std::invalid_argument
+    // otherwise.
+    template <typename R, typename S>
+    void Depend(TaskNode<R> node, TaskNode<S> on) {
+        AddDep(node.id, on.id);
+    }
+
+    // Runs every node on `executors` coroutines and suspends the caller
+    // until all finished. Rethrows the first exception of a node, the
+    // nodes depending on it never start. Once per graph.
+    void Run(int executors = 8, const Config &config = Config("executor")) {
+        assert(not ran_);
+        ran_ = true;
+        for (auto &node : nodes_) {
+            node->unfinished = node->deps.size();
+            if (node->unfinished == 0) {
+                ready_.push_back(node.get());
+            }
+        }
+        started_ = TaskClock::now();
+        TaskGroup<> group;
+        for (int i = 0; i < std::min(executors, Size()); ++i) {
+            group.Spawn(config, &TaskGraph::Executor, this);
+        }
+        group.WaitAll();
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+    }
+
+    // only for a node that finished, not one that threw or never started
+    template <typename R>
+    auto &Result(TaskNode<R> node) {
+        assert(node.node->result.has_value());
+        return *node.node->result;
+    }
+
+    // Walks back from the node finishing last through the dependency that
+    // finished last each time, the chain that bounded the run.
+    std::vector<CriticalStep> CriticalPath() const {
+        std::vector<CriticalStep> path;
+        const detail::GraphNode *node = nullptr;
+        for (auto &n : nodes_) {
+            if (node == nullptr or n->end > node->end) {
+                node = n.get();
+            }
+        }
+        for (; node != nullptr;) {
+            const detail::GraphNode *gate = nullptr;
+            for (int dep : node->deps) {
+                const detail::GraphNode *d = nodes_[dep].get();
+                if (gate == nullptr or d->end > gate->end) {
+                    gate = d;
+                }
+            }
+            TaskClock::time_point ready = gate ? gate->end : started_;
+            path.push_back(
+                {node->name, node->start - ready, node->end - node->start});
+            node = gate;
+        }
+        std::reverse(path.begin(), path.end());
+        return path;
+    }
+
+    TaskClock::duration Elapsed() const {
+        return finished_ - started_;
+    }
+
+    int Size() const {
+        return nodes_.size();
+    }
+
+  private:
+    template <typename A>
+    void AddArgDep(int id, const A &a) {
+        if constexpr (detail::IsTaskNode<A>::value) {
+            AddDep(id, a.id);
+        }
+    }
+
+    void AddDep(int id, int on) {
+        if (on >= id) {
+            throw std::invalid_argument(
+                nodes_[id]->name + " can't depend on a later node");
+        }
+        nodes_[id]->deps.push_back(on);
+        nodes_[on]->dependents.push_back(id);
+    }
+
+    static void Executor(TaskGraph *g) {
+        for (; g->done_ < g->Size() and not g->error_;) {
+            if (g->ready_.empty()) {
+                detail::Park(g->idle_);
+                continue;
+            }
+            detail::GraphNode *node = g->ready_.front();
+            g->ready_.pop_front();
+            g->Execute(node);
+        }
+    }
+
+    void Execute(detail::GraphNode *node) {
+        node->start = TaskClock::now();
+        try {
+            node->Execute();
+        } catch (...) {
+            if (not error_) {
+                error_ = std::current_exception();
+            }
+            detail::UnparkAll(idle_);
+            return;
+        }
+        node->end = finished_ = TaskClock::now();
+        ++done_;
+        for (int id : node->dependents) {
+            detail::GraphNode *d = nodes_[id].get();
+            if (--d->unfinished == 0) {
+                ready_.push_back(d);
+                detail::UnparkOne(idle_);
+            }
+        }
+        if (done_ == Size()) {
+            detail::UnparkAll(idle_);
+        }
+    }
+
+    std::vector<std::unique_ptr<detail::GraphNode>> nodes_;
+    std::deque<detail::GraphNode *> ready_;
+    detail::WaitList<detail::SyncWaiter> idle_;
+    int done_ = 0;
+    std::exception_ptr error_;
+    bool ran_ = false;
+
+    TaskClock::time_point started_;
+    TaskClock::time_point finished_;
+};
+
+} // namespace conjure
+
+#endif // CONJURE_TASK_GRAPH_H_
@@ -0,0 +1,183 @@
+#ifndef CONJURE_TASK_GROUP_H_
+#define CONJURE_TASK_GROUP_H_
+
+#include "conjure/interfaces.h"
+#include <assert.h>
+#include <algorithm>
+#include <exception>
+#include <optional>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace conjure {
+
+class GroupCancelled : public std::runtime_error {
+  public:
+    GroupCancelled()
+        : std::runtime_error("task group cancelled before all children ran") {}
+};
+
+// Children spawned into a group start from the ready queue while their
+// parent, the coroutine that created the group, goes on. The parent suspends
+// once for all or any of them and the child completing the wait readies it
+// directly. The first exception cancels the children that haven't started,
+// the running ones may check Cancelled(). Finished children are freed in one
+// go, the destructor waits for every child first.
+//
+//     TaskGroup<int> group;
+//     for (auto &url : urls) group.Spawn(Config{}, Fetch, url);
+//     std::vector<int> sizes = group.WaitAll();
+template <typename R = void>
+class TaskGroup {
+  public:
+    using ResultT = std::conditional_t<std::is_void_v<R>, Void, R>;
+
+    TaskGroup() : parent_(ActiveConjury()) {}
+
+    TaskGroup(const TaskGroup &) = delete;
+    TaskGroup &operator=(const TaskGroup &) = delete;
+
+    ~TaskGroup() {
+        Await(Size());
+        Reclaim();
+    }
+
+    // returns the index of the child's result
+    template <typename F, typename... Args>
+    int Spawn(const Config &config, F f, Args... args) {
+        int index = Size();
+        results_.emplace_back();
+        Conjury *co = Conjure(
+            config, [this, index, f = std::move(f),
+                     args = std::make_tuple(std::move(args)...)]() mutable {
+                Run(index, f, args);
+            });
+        children_.push_back(co);
+        Conjurer::Instance()->Spawn(co);
+        return index;
+    }
+
+    // Suspends until every child finished and rethrows the first exception
+    // of any of them, otherwise returns the results in spawn order. Throws
+    // GroupCancelled if Cancel() kept a child from running.
+    auto WaitAll() {
+        Await(Size());
+        Reclaim();
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+        for (std::optional<ResultT> &r : results_) {
+            if (not r) {
+                throw GroupCancelled();
+            }
+        }
+        if constexpr (not std::is_void_v<R>) {
+            std::vector<R> results;
+            results.reserve(results_.size());
+            for (std::optional<R> &r : results_) {
+                results.push_back(std::move(*r));
+            }
+            return results;
+        }
+    }
+
+    // Suspends until a child not reported yet finished and returns its
+    // index, -1 once all of them were.
+    int WaitAny() {
+        Await(std::min(reported_ + 1, Size()));
+        if (reported_ == (int)finish_order_.size()) {
+            return -1;
+        }
+        return finish_order_[reported_++];
+    }
+
+    // the result of a finished child, empty if it threw or was cancelled
+    std::optional<ResultT> &Result(int index) {
+        return results_.at(index);
+    }
+
+    // keeps children that haven't started from running
+    void Cancel() {
+        cancelled_ = true;
+    }
+
+    bool Cancelled() const {
+        return cancelled_;
+    }
+
+    int Size() const {
+        return children_.size();
+    }
+
+    int FinishedCount() const {
+        return finish_order_.size();
+    }
+
+  private:
+    template <typename F, typename Tuple>
+    void Run(int index, F &f, Tuple &args) {
+        if (not cancelled_) {
+            try {
+                if constexpr (std::is_void_v<R>) {
+                    std::apply(f, std::move(args));
+                    results_[index].emplace();
+                } else {
+                    results_[index].emplace(std::apply(f, std::move(args)));
+                }
+            } catch (...) {
+                if (not error_) {
+                    error_ = std::current_exception();
+                }
+                cancelled_ = true;
+            }
+        }
+        finish_order_.push_back(index);
+        if (waiting_ and FinishedCount() >= wanted_) {
+            waiting_ = false;
+            Conjurer::Instance()->Ready(parent_);
+        }
+    }
+
+    // suspends again if woken by anything but the child completing the wait
+    void Await(int n) {
+        assert(ActiveConjury() == parent_);
+        wanted_ = n;
+        for (; FinishedCount() < n;) {
+            waiting_ = true;
+            Suspend();
+        }
+        waiting_ = false;
+    }
+
+    // the children finished since the last call
+    void Reclaim() {
+        std::vector<const Conjury *> done;
+        for (Conjury *&co : children_) {
+            if (co != nullptr and co->IsFinished()) {
+                done.push_back(co);
+                co = nullptr;
+            }
+        }
+        if (not done.empty()) {
+            Conjurer::Instance()->Reclaim(std::move(done));
+        }
+    }
+
+    Conjury *parent_;
+    std::vector<Conjury *> children_;
+    std::vector<std::optional<ResultT>> results_;
+    std::vector<int> finish_order_;
+    int reported_ = 0;
+
+    int wanted_ = 0;
+    bool waiting_ = false;
+    bool cancelled_ = false;
+    std::exception_ptr error_;
+};
+
+} // namespace conjure
+
+#endif // CONJURE_TASK_GROUP_H_
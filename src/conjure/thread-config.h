@@ -0,0 +1,87 @@
+#ifndef CONJURE_THREAD_CONFIG_H_
+#define CONJURE_THREAD_CONFIG_H_
+
+#include <pthread.h>
+#include <sched.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace conjure {
+
+// Placement and naming of a thread running workers or a scheduler
+struct ThreadConfig {
+    // thread names are cut to what the kernel keeps
+    static constexpr int kMaxNameLength = 15;
+
+    ThreadConfig() = default;
+
+    ThreadConfig(const std::string &name, std::vector<int> cpus = {})
+        : name(name), cpus(std::move(cpus)) {}
+
+    // empty for no name change
+    std::string name;
+
+    // CPUs the thread may run on, empty for no pinning
+    std::vector<int> cpus;
+
+    // Applies the config to `thread`, returns false if any part of it was
+    // rejected, e.g. CPUs that don't exist.
+    bool ApplyTo(pthread_t thread) const {
+        bool ok = true;
+#ifdef __linux__
+        if (not cpus.empty()) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            for (int cpu : cpus) {
+                if (cpu >= 0 and cpu < CPU_SETSIZE) {
+                    CPU_SET(cpu, &set);
+                }
+            }
+            ok = pthread_setaffinity_np(thread, sizeof(set), &set) == 0;
+        }
+        if (not name.empty()) {
+            std::string cut = name.substr(0, kMaxNameLength);
+            ok = pthread_setname_np(thread, cut.c_str()) == 0 and ok;
+        }
+#else
+        (void)thread;
+        ok = cpus.empty() and name.empty();
+#endif // __linux__
+        return ok;
+    }
+
+    bool ApplyToCurrent() const {
+        return ApplyTo(pthread_self());
+    }
+
+    // what the kernel reports for `thread`, as opposed to what was asked for
+    static ThreadConfig Of(pthread_t thread) {
+        ThreadConfig config;
+#ifdef __linux__
+        char name[kMaxNameLength + 1] = {};
+        if (pthread_getname_np(thread, name, sizeof(name)) == 0) {
+            config.name = name;
+        }
+        cpu_set_t set;
+        if (pthread_getaffinity_np(thread, sizeof(set), &set) == 0) {
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                if (CPU_ISSET(cpu, &set)) {
+                    config.cpus.push_back(cpu);
+                }
+            }
+        }
+#else
+        (void)thread;
+#endif // __linux__
+        return config;
+    }
+
+    static ThreadConfig OfCurrent() {
+        return Of(pthread_self());
+    }
+};
+
+} // namespace conjure
+
+#endif // CONJURE_THREAD_CONFIG_H_
@@ -0,0 +1,135 @@
+#ifndef CONJURE_TIMER_H_
+#define CONJURE_TIMER_H_
+
+#include "conjure/conjury.h"
+#include "conjure/select-state.h"
+#include <assert.h>
+#include <chrono>
+#include <vector>
+
+namespace conjure {
+
+using TimerClock = std::chrono::steady_clock;
+
+namespace detail {
+
+// Wakes `conjury` at `deadline`. Lives on the waiting coroutine's stack and
+// must be removed from the scheduler before it goes away unless it fired.
+struct Timer {
+    Timer(TimerClock::time_point deadline, Conjury *conjury)
+        : deadline(deadline), conjury(conjury) {}
+
+    void Fire() {
+        if (select == nullptr or select->TryClaim(index)) {
+            conjury->Wake();
+        }
+    }
+
+    TimerClock::time_point deadline;
+    Conjury *conjury;
+
+    SelectState *select = nullptr;
+    int index = 0;
+
+    int heap_index = -1;
+};
+
+// Binary min-heap of timers by deadline. Timers know their position, so
+// removing one is logarithmic as well.
+class TimerHeap {
+  public:
+    bool Empty() const {
+        return heap_.empty();
+    }
+
+    bool Due(TimerClock::time_point now) const {
+        return not heap_.empty() and heap_.front()->deadline <= now;
+    }
+
+    TimerClock::time_point NextDeadline() const {
+        assert(not heap_.empty());
+        return heap_.front()->deadline;
+    }
+
+    void Push(Timer *t) {
+        assert(t->heap_index == -1);
+        t->heap_index = heap_.size();
+        heap_.push_back(t);
+        SiftUp(t->heap_index);
+    }
+
+    // returns false if `t` already fired
+    bool Remove(Timer *t) {
+        int i = t->heap_index;
+        if (i == -1) {
+            return false;
+        }
+        Timer *last = heap_.back();
+        heap_.pop_back();
+        t->heap_index = -1;
+        if (last != t) {
+            Place(last, i);
+            SiftDown(SiftUp(i));
+        }
+        return true;
+    }
+
+    // fires timers due at `now`, returns how many
+    int FireDue(TimerClock::time_point now) {
+        int fired = 0;
+        for (; Due(now); ++fired) {
+            Timer *t = heap_.front();
+            Remove(t);
+            t->Fire();
+        }
+        return fired;
+    }
+
+  private:
+    void Place(Timer *t, int i) {
+        heap_[i] = t;
+        t->heap_index = i;
+    }
+
+    int SiftUp(int i) {
+        for (; i > 0;) {
+            int parent = (i - 1) / 2;
+            if (heap_[parent]->deadline <= heap_[i]->deadline) {
+                break;
+            }
+            Timer *p = heap_[parent];
+            Place(heap_[i], parent);
+            Place(p, i);
+            i = parent;
+        }
+        return i;
+    }
+
+    void SiftDown(int i) {
+        int n = heap_.size();
+        for (;;) {
+            int least = i;
+            for (int child : {2 * i + 1, 2 * i + 2}) {
+                if (child < n and
+                    heap_[child]->deadline < heap_[least]->deadline) {
+                    least = child;
+                }
+            }
+            if (least == i) {
+                break;
+            }
+            Timer *t = heap_[least];
+            Place(heap_[i], least);
+            Place(t, i);
+            i = least;
+        }
+    }
+
+    std::vector<Timer *> heap_;
+};
+
+} // namespace detail
+
+} // namespace conjure
+
+#endif // CONJURE_TIMER_H_
@@ -1,8 +1,11 @@
 #ifndef CONJURE_VALUE_TUNNEL_H_
 #define CONJURE_VALUE_TUNNEL_H_
 
+#include <assert.h>
 #include <stdio.h>
 #include <optional>
+#include <type_traits>
+#include <utility>
 
 namespace conjure {
 
@@ -13,19 +16,60 @@ class ValueTunnel {
         return value_ptr_ == nullptr;
     }
 
+    // the value passed, kept for the next call
+    const T *Peek() const {
+        return value_ptr_;
+    }
+
+    void Clear() {
+        value_ptr_ = nullptr;
+    }
+
     const T *GetOne() {
         const T *a = value_ptr_;
         value_ptr_ = nullptr;
         return a;
     }
 
+    // Moves the value out if it was passed as an rvalue, which only the
+    // receiver sees again. Lvalues may be reused by the sender so they're
+    // copied.
+    T Take() {
+        assert(value_ptr_ != nullptr);
+        T *value = const_cast<T *>(value_ptr_);
+        value_ptr_ = nullptr;
+        if constexpr (std::is_copy_constructible_v<T>) {
+            if (not movable_) {
+                return *value;
+            }
+        } else {
+            assert(movable_);
+        }
+        return std::move(*value);
+    }
+
     bool Pass(const T &value) {
         value_ptr_ = &value;
+        movable_ = false;
+        return true;
+    }
+
+    bool Pass(T &&value) {
+        value_ptr_ = &value;
+        movable_ = true;
+        return true;
+    }
+
+    // hands on what `from` was passed, movable or not
+    bool Pass(ValueTunnel &from) {
+        value_ptr_ = std::exchange(from.value_ptr_, nullptr);
+        movable_ = from.movable_;
         return true;
     }
 
   private:
     const T *value_ptr_ = nullptr;
+    bool movable_ = false;
 };
 
 } // namespace conjure
@@ -0,0 +1,61 @@
+#ifndef CONJURE_WAIT_LIST_H_
+#define CONJURE_WAIT_LIST_H_
+
+#include <assert.h>
+
+namespace conjure::detail {
+
+// Intrusive FIFO of waiter nodes living on the waiting coroutines' stacks.
+// `Node` needs `Node *prev` and `Node *next` members, both null while
+// unlinked. Not thread-safe, waiters and wakers share one scheduler.
+template <typename Node>
+class WaitList {
+  public:
+    bool Empty() const {
+        return head_ == nullptr;
+    }
+
+    Node *Front() const {
+        return head_;
+    }
+
+    void PushBack(Node *node) {
+        assert(node->prev == nullptr and node->next == nullptr);
+        node->prev = tail_;
+        if (tail_ != nullptr) {
+            tail_->next = node;
+        } else {
+            head_ = node;
+        }
+        tail_ = node;
+    }
+
+    Node *PopFront() {
+        Node *node = head_;
+        if (node != nullptr) {
+            Remove(node);
+        }
+        return node;
+    }
+
+    // `node` must be linked into this list
+    void Remove(Node *node) {
+        (node->prev != nullptr ? node->prev->next : head_) = node->next;
+        (node->next != nullptr ? node->next->prev : tail_) = node->prev;
+        node->prev = nullptr;
+        node->next = nullptr;
+    }
+
+    // for nodes that are in no other list
+    bool Contains(const Node *node) const {
+        return node->prev != nullptr or head_ == node;
+    }
+
+  private:
+    Node *head_ = nullptr;
+    Node *tail_ = nullptr;
+};
+
+} // namespace conjure::detail
+
+#endif // CONJURE_WAIT_LIST_H_